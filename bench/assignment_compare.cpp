@@ -0,0 +1,228 @@
+// Очередь как сейчас против AssignmentEngine::solve() на LoadSimulator.
+//
+// Врачи — узкие специалисты и терапевты. Пациент либо со специальностью
+// (его принимает только специалист этого профиля), либо общий (~40%, его
+// принимает любой). Специалист ведёт общего пациента дольше терапевта —
+// см. kOffProfileSlowdown. Длительность приёма симулятор берёт из
+// service_minutes().
+//
+// «greedy» — текущая дисциплина очереди: освободившийся врач берёт самого
+// срочного из тех, кого может принять, при равном триаже — дольше ждущего.
+// «solve()» — все свободные врачи разом по минимуму суммарной pair_cost,
+// где ожидаемая длительность приёма зависит от пары.
+// Сравниваются среднее и хвост ожидания по нескольким seed; в конце —
+// время одного solve() на матрице 500 x 500.
+//
+//   assignment_compare [seeds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "AssignmentEngine.h"
+#include "LoadSimulator.h"
+
+namespace {
+
+constexpr int    kSpecialties = 3;
+constexpr int    kSpecialists = 6; // врачи 0..5 — специалисты, остальные — терапевты
+constexpr double kOffProfileSlowdown = 1.5;
+
+// Специальность пациента выводится из id: ~40% — общие (-1)
+int patientSpecialty(std::uint64_t id)
+{
+    const std::uint64_t h = id * 0x9E3779B97F4A7C15ull;
+    return (h >> 60) < 6 ? -1 : static_cast<int>((h >> 32) % kSpecialties);
+}
+
+// -1 — терапевт
+int doctorSpecialty(int doctor) { return doctor < kSpecialists ? doctor % kSpecialties : -1; }
+
+bool canTreat(int patientSpec, int doctor)
+{
+    return patientSpec < 0 || patientSpec == doctorSpecialty(doctor);
+}
+
+// Во сколько раз приём дольше обычного: специалист с общим пациентом медленнее
+double slowdown(int patientSpec, int doctor)
+{
+    return patientSpec < 0 && doctorSpecialty(doctor) >= 0 ? kOffProfileSlowdown : 1.0;
+}
+
+class Clinic {
+public:
+    explicit Clinic(double meanServiceMinutes) : meanService_(meanServiceMinutes) {}
+
+    void enqueue(std::uint64_t patientId, int triage, double simMinute)
+    {
+        waiting_.push_back(Waiting{patientId, triage, simMinute, patientSpecialty(patientId)});
+    }
+
+    bool cancel(std::uint64_t patientId, double)
+    {
+        for (std::size_t i = 0; i < waiting_.size(); ++i)
+            if (waiting_[i].id == patientId) {
+                take(i);
+                return true;
+            }
+        return false;
+    }
+
+    double service_minutes(int doctor, std::uint64_t patientId, double baseMinutes) const
+    {
+        return baseMinutes * slowdown(patientSpecialty(patientId), doctor);
+    }
+
+protected:
+    struct Waiting {
+        std::uint64_t id;
+        int           triage;
+        double        since;
+        int           specialty;
+    };
+
+    std::uint64_t take(std::size_t i)
+    {
+        const std::uint64_t id = waiting_[i].id;
+        waiting_[i] = waiting_.back();
+        waiting_.pop_back();
+        return id;
+    }
+
+    double               meanService_;
+    std::vector<Waiting> waiting_;
+};
+
+// Каждый свободный врач по очереди берёт самого срочного из своих пациентов
+struct GreedyClinic : Clinic {
+    using Clinic::Clinic;
+
+    std::vector<std::pair<int, std::uint64_t>> assign(const std::vector<int>& idleDoctors, double)
+    {
+        std::vector<std::pair<int, std::uint64_t>> out;
+        for (int doctor : idleDoctors) {
+            std::optional<std::size_t> best;
+            for (std::size_t i = 0; i < waiting_.size(); ++i) {
+                const Waiting& w = waiting_[i];
+                if (!canTreat(w.specialty, doctor))
+                    continue;
+                if (!best || w.triage < waiting_[*best].triage
+                    || (w.triage == waiting_[*best].triage && w.since < waiting_[*best].since))
+                    best = i;
+            }
+            if (best)
+                out.emplace_back(doctor, take(*best));
+        }
+        return out;
+    }
+};
+
+// Все свободные врачи разом: минимум суммарной стоимости
+struct OptimalClinic : Clinic {
+    OptimalClinic(double meanServiceMinutes, AssignmentEngine::Weights weights)
+        : Clinic(meanServiceMinutes), weights_(weights)
+    {
+    }
+
+    std::vector<std::pair<int, std::uint64_t>> assign(const std::vector<int>& idleDoctors, double now)
+    {
+        const std::vector<int> rows = AssignmentEngine::assign(waiting_, idleDoctors, [&](const Waiting& w, int doctor) {
+            return AssignmentEngine::pair_cost(weights_, canTreat(w.specialty, doctor), w.triage, now - w.since,
+                                               meanService_ * slowdown(w.specialty, doctor));
+        });
+
+        std::vector<std::pair<int, std::uint64_t>> out;
+        for (std::size_t i = 0; i < rows.size(); ++i)
+            if (rows[i] >= 0)
+                out.emplace_back(idleDoctors[rows[i]], waiting_[i].id);
+        for (const auto& [doctor, id] : out)
+            cancel(id, now);
+        return out;
+    }
+
+    AssignmentEngine::Weights weights_;
+};
+
+struct Totals {
+    double mean = 0, p90 = 0, p99 = 0, served = 0;
+
+    void add(LoadSimulator::Report& r)
+    {
+        mean += r.waitSeconds.mean() / 60.0;
+        p90 += r.waitSeconds.percentile(0.9) / 60.0;
+        p99 += r.waitSeconds.percentile(0.99) / 60.0;
+        served += static_cast<double>(r.served);
+    }
+
+    void print(const char* name, int runs) const
+    {
+        std::printf("%-8s served=%.0f  wait mean=%.1fmin p90=%.1fmin p99=%.1fmin\n", name, served / runs,
+                    mean / runs, p90 / runs, p99 / runs);
+    }
+};
+
+// Медиана и максимум времени solve() на случайной матрице n x n с долей запрещённых пар
+void timeSolve(std::size_t n, double forbiddenShare, int runs)
+{
+    std::vector<double> ms;
+    for (int s = 0; s < runs; ++s) {
+        std::mt19937_64 rng(static_cast<std::uint64_t>(s));
+        std::uniform_real_distribution<double> cost(0.0, 1000.0);
+        std::bernoulli_distribution forbidden(forbiddenShare);
+        std::vector<double> c(n * n);
+        for (double& x : c)
+            x = forbidden(rng) ? AssignmentEngine::kForbidden : cost(rng);
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<int> rows = AssignmentEngine::solve(c, n, n);
+        ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        if (rows.size() != n)
+            std::abort();
+    }
+    std::sort(ms.begin(), ms.end());
+    std::printf("solve() %zux%zu, %.0f%% forbidden: median %.2fms max %.2fms\n", n, n, forbiddenShare * 100,
+                ms[ms.size() / 2], ms.back());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int seeds = argc > 1 ? std::atoi(argv[1]) : 10;
+
+    LoadSimulator::Config config;
+    config.doctors = 9;
+    config.meanServiceMinutes = 12.0;
+    config.arrivalsPerMinute = 0.55; // ρ ≈ 0.73 без учёта замедления специалистов
+    config.durationMinutes = 10 * 60.0;
+
+    const AssignmentEngine::Weights weights;
+    Totals greedy, optimal;
+    for (int seed = 1; seed <= seeds; ++seed) {
+        config.seed = static_cast<std::uint64_t>(seed);
+        const LoadSimulator sim(config);
+        const auto trace = sim.generate();
+
+        GreedyClinic g(config.meanServiceMinutes);
+        LoadSimulator::Report rg = sim.run(g, trace);
+        greedy.add(rg);
+
+        OptimalClinic o(config.meanServiceMinutes, weights);
+        LoadSimulator::Report ro = sim.run(o, trace);
+        optimal.add(ro);
+    }
+
+    std::printf("%d doctors (%d specialists), %d specialties, %.2f arrivals/min, %d seeds\n", config.doctors,
+                kSpecialists, kSpecialties, config.arrivalsPerMinute, seeds);
+    greedy.print("greedy", seeds);
+    optimal.print("solve()", seeds);
+
+    timeSolve(500, 0.0, 15);
+    timeSolve(500, 0.2, 15);
+}
@@ -0,0 +1,159 @@
+// IndexedDaryHeap против std::priority_queue с ленивым удалением на
+// смешанной нагрузке очереди: push / update_priority / erase / pop.
+//
+// У std::priority_queue нет ни смены приоритета, ни удаления из середины:
+// update кладёт новую запись, erase только снимает id с учёта, а pop
+// пропускает устаревшие записи (приоритет не совпал с текущим или id уже
+// снят). Куча от этого разрастается — её итоговый размер печатается рядом.
+//
+// Ключ — (триаж, номер прихода), он уникален, поэтому обе очереди отдают
+// пациентов в одном порядке и проходят одну и ту же последовательность
+// операций; совпадение проверяется контрольной суммой.
+//
+//   indexed_heap_compare [ops] [live]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "IndexedDaryHeap.h"
+
+namespace {
+
+using Key = std::pair<int, std::uint64_t>; // (триаж, номер прихода)
+
+struct Indexed {
+    void push(std::uint64_t id, Key key) { heap.push(id, key); }
+    void update(std::uint64_t id, Key key) { heap.update_priority(id, key); }
+    void erase(std::uint64_t id) { heap.erase(id); }
+
+    std::optional<std::uint64_t> pop()
+    {
+        if (heap.empty())
+            return std::nullopt;
+        const std::uint64_t id = heap.top().id;
+        heap.pop();
+        return id;
+    }
+
+    std::size_t footprint() const { return heap.size(); }
+
+    IndexedDaryHeap<std::uint64_t, Key> heap;
+};
+
+struct Lazy {
+    using Item = std::pair<Key, std::uint64_t>;
+
+    void push(std::uint64_t id, Key key)
+    {
+        current[id] = key;
+        heap.emplace(key, id);
+    }
+
+    void update(std::uint64_t id, Key key) { push(id, key); }
+    void erase(std::uint64_t id) { current.erase(id); }
+
+    std::optional<std::uint64_t> pop()
+    {
+        while (!heap.empty()) {
+            const auto [key, id] = heap.top();
+            heap.pop();
+            auto it = current.find(id);
+            if (it != current.end() && it->second == key) {
+                current.erase(it);
+                return id;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::size_t footprint() const { return heap.size(); }
+
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+    std::unordered_map<std::uint64_t, Key>                           current;
+};
+
+struct Result {
+    double        ms = 0;
+    std::uint64_t checksum = 0;
+    std::size_t   footprint = 0;
+};
+
+// Доли операций: 35% push, 30% update, 10% erase, 25% pop — приход равен уходу,
+// и очередь держится около live
+template <typename Queue>
+Result run(std::size_t ops, std::size_t live, std::uint64_t seed)
+{
+    Queue q;
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> triage(1, 5);
+    std::vector<std::uint64_t> ids; // кто сейчас в очереди (для update/erase)
+    std::unordered_map<std::uint64_t, std::size_t> slot;
+    std::uint64_t next = 0;
+    Result r;
+
+    auto forget = [&](std::uint64_t id) {
+        const std::size_t i = slot.at(id);
+        ids[i] = ids.back();
+        slot[ids[i]] = i;
+        ids.pop_back();
+        slot.erase(id);
+    };
+    auto add = [&] {
+        const std::uint64_t id = next++;
+        q.push(id, Key{triage(rng), id});
+        slot[id] = ids.size();
+        ids.push_back(id);
+    };
+
+    for (std::size_t i = 0; i < live; ++i)
+        add();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        const auto dice = rng() % 100;
+        if (dice < 35 || ids.empty()) {
+            add();
+        } else if (dice < 65) {
+            const std::uint64_t id = ids[rng() % ids.size()];
+            q.update(id, Key{triage(rng), id});
+        } else if (dice < 75) {
+            const std::uint64_t id = ids[rng() % ids.size()];
+            q.erase(id);
+            forget(id);
+        } else if (const auto id = q.pop()) {
+            r.checksum = r.checksum * 31 + *id;
+            forget(*id);
+        }
+    }
+    r.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    r.footprint = q.footprint();
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t ops  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t live = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+
+    const Result indexed = run<Indexed>(ops, live, 1);
+    const Result lazy    = run<Lazy>(ops, live, 1);
+
+    std::printf("%zu ops, ~%zu live patients (35%% push, 30%% update, 10%% erase, 25%% pop)\n", ops, live);
+    std::printf("%-28s %9.1fms %7.1f ns/op  entries=%zu\n", "IndexedDaryHeap", indexed.ms,
+                indexed.ms * 1e6 / static_cast<double>(ops), indexed.footprint);
+    std::printf("%-28s %9.1fms %7.1f ns/op  entries=%zu\n", "priority_queue + lazy delete", lazy.ms,
+                lazy.ms * 1e6 / static_cast<double>(ops), lazy.footprint);
+    if (indexed.checksum != lazy.checksum)
+        std::printf("warning: pop sequences differ\n");
+}
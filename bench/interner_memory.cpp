@@ -0,0 +1,134 @@
+// Сколько памяти экономит StringInterner на типичном наборе визитов.
+//
+// Генерируется n визитов с отделением, специальностью врача и диагнозом
+// (код МКБ-10 с описанием); частоты — по закону Ципфа, как в реальных
+// выгрузках: несколько отделений и диагнозов встречаются постоянно, хвост —
+// редко. Один и тот же набор хранится двумя способами:
+//   before — три std::string в каждой записи;
+//   after  — три InternedString в записи плюс сама таблица интернирования.
+// Память — прирост занятой кучи по mallinfo2() (glibc), то есть с
+// заголовками блоков malloc, плюс сами массивы записей.
+//
+//   interner_memory [visits]
+
+#include <malloc.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "StringInterner.h"
+
+namespace {
+
+const char* const kDepartments[] = {
+    "Приёмное отделение", "Терапевтическое отделение", "Кардиологическое отделение",
+    "Неврологическое отделение", "Хирургическое отделение", "Травматологическое отделение",
+    "Гастроэнтерологическое отделение", "Пульмонологическое отделение", "Эндокринологическое отделение",
+    "Отделение функциональной диагностики", "Офтальмологическое отделение", "Оториноларингологическое отделение",
+};
+
+const char* const kSpecialties[] = {
+    "Врач-терапевт", "Врач-кардиолог", "Врач-невролог", "Врач-хирург", "Врач-травматолог-ортопед",
+    "Врач-гастроэнтеролог", "Врач-пульмонолог", "Врач-эндокринолог", "Врач-офтальмолог",
+    "Врач-оториноларинголог", "Врач функциональной диагностики", "Врач общей практики",
+};
+
+const char* const kConditions[] = {
+    "Острая инфекция верхних дыхательных путей неуточнённая", "Эссенциальная (первичная) гипертензия",
+    "Инсулиннезависимый сахарный диабет без осложнений", "Боль в пояснично-крестцовом отделе позвоночника",
+    "Хронический гастрит неуточнённый", "Стабильная стенокардия напряжения", "Мигрень неуточнённая",
+    "Ушиб коленного сустава", "Бронхиальная астма смешанной формы", "Острый бронхит неуточнённый",
+};
+
+// Распределение Ципфа на k значениях
+std::discrete_distribution<std::size_t> zipf(std::size_t k)
+{
+    std::vector<double> w(k);
+    for (std::size_t i = 0; i < k; ++i)
+        w[i] = 1.0 / static_cast<double>(i + 1);
+    return std::discrete_distribution<std::size_t>(w.begin(), w.end());
+}
+
+struct Visit {
+    std::int64_t id;
+    std::string  department;
+    std::string  specialty;
+    std::string  diagnosis;
+};
+
+struct CompactVisit {
+    std::int64_t   id;
+    InternedString department;
+    InternedString specialty;
+    InternedString diagnosis;
+};
+
+// Занято malloc: обычные блоки плюс крупные, выделенные через mmap
+std::size_t heapInUse()
+{
+    const struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    // 400 диагнозов: код МКБ-10 + описание
+    std::vector<std::string> diagnoses;
+    for (std::size_t i = 0; i < 400; ++i) {
+        char code[16];
+        std::snprintf(code, sizeof(code), "%c%02zu.%zu ", static_cast<char>('A' + i % 26), i % 100, i % 10);
+        diagnoses.push_back(code + std::string(kConditions[i % std::size(kConditions)]));
+    }
+
+    std::mt19937_64 rng(1);
+    auto department = zipf(std::size(kDepartments));
+    auto specialty  = zipf(std::size(kSpecialties));
+    auto diagnosis  = zipf(diagnoses.size());
+    struct Pick {
+        std::size_t department, specialty, diagnosis;
+    };
+    std::vector<Pick> picks(n);
+    for (Pick& p : picks)
+        p = Pick{department(rng), specialty(rng), diagnosis(rng)};
+
+    std::size_t before = 0, after = 0;
+    {
+        const std::size_t heap0 = heapInUse();
+        std::vector<Visit> visits;
+        visits.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            visits.push_back(Visit{static_cast<std::int64_t>(i), kDepartments[picks[i].department],
+                                   kSpecialties[picks[i].specialty], diagnoses[picks[i].diagnosis]});
+        before = heapInUse() - heap0;
+    }
+    StringInterner::Stats stats;
+    {
+        const std::size_t heap0 = heapInUse();
+        StringInterner interner;
+        std::vector<CompactVisit> visits;
+        visits.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            visits.push_back(CompactVisit{static_cast<std::int64_t>(i), interner.intern(kDepartments[picks[i].department]),
+                                          interner.intern(kSpecialties[picks[i].specialty]),
+                                          interner.intern(diagnoses[picks[i].diagnosis])});
+        after = heapInUse() - heap0;
+        stats = interner.stats();
+    }
+
+    const double mb = 1024.0 * 1024.0;
+    std::printf("%zu visits, %zu unique strings, %.1f MB of text passed to intern()\n", n, stats.strings,
+                static_cast<double>(stats.requestedBytes) / mb);
+    std::printf("before (std::string x3, %zu B/record): %8.1f MB\n", sizeof(Visit), static_cast<double>(before) / mb);
+    std::printf("after  (handles x3, %zu B/record):      %8.1f MB (table text %.1f KB)\n", sizeof(CompactVisit),
+                static_cast<double>(after) / mb, static_cast<double>(stats.bytes) / 1024.0);
+    std::printf("saved: %.1f MB (%.1fx smaller)\n", static_cast<double>(before - after) / mb,
+                after ? static_cast<double>(before) / static_cast<double>(after) : 0.0);
+}
@@ -0,0 +1,214 @@
+// Прогон LoadSimulator на очереди IndexedDaryHeap: триаж, затем порядок
+// прихода. Печатает задержки вызовов очереди, число аллокаций в них и
+// модельное ожидание.
+//
+// Каждый dequeue, как настоящий dequeue-and-assign, строит временный граф
+// запроса: кандидатов (PatientRecord), врача (DoctorRecord) и визит
+// (VisitRecord) со строками и контейнерами. HeapDriver берёт для них память
+// из кучи, ArenaDriver — из RequestArena, сбрасываемой в конце запроса.
+// Оба гоняются по одной трассе, в конце — сводка аллокаций рядом.
+//
+//   load_simulator [arrivals/min] [doctors] [hours] [seed] [cancel probability] [patience min]
+//
+// Отмены по умолчанию — у 30% пациентов, терпение в среднем 15 минут;
+// например, "load_simulator 0.7 10 8 42 0" гоняет без отмен.
+
+// Этот main подменяет operator new, чтобы allocation_count() считал по-настоящему
+#define ALLOCATION_COUNTER_INSTALL
+#include "AllocationCounter.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+
+#include "IndexedDaryHeap.h"
+#include "LoadSimulator.h"
+#include "RequestArena.h"
+
+namespace {
+
+constexpr int kCandidates = 20; // пациентов, которых запрос разбирает перед выбором
+
+// Строка сразу в памяти ресурса — без временной std::string в куче
+std::pmr::string label(const char* prefix, std::uint64_t id, const std::pmr::polymorphic_allocator<char>& alloc)
+{
+    char buf[64];
+    const int n = std::snprintf(buf, sizeof(buf), "%s #%llu (full name)", prefix, static_cast<unsigned long long>(id));
+    return std::pmr::string(buf, static_cast<std::size_t>(n), alloc);
+}
+
+// Временные записи запроса. pmr-aware: память — из переданного ресурса,
+// контейнеры передают его элементам сами (uses-allocator)
+struct PatientRecord {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    PatientRecord(std::uint64_t id, int triage, const allocator_type& alloc)
+        : id(id), triage(triage), name(label("Patient", id, alloc)),
+          diagnosis("diagnosis code and free-text note", alloc)
+    {
+    }
+    PatientRecord(const PatientRecord& o, const allocator_type& alloc)
+        : id(o.id), triage(o.triage), name(o.name, alloc), diagnosis(o.diagnosis, alloc)
+    {
+    }
+    PatientRecord(PatientRecord&& o, const allocator_type& alloc)
+        : id(o.id), triage(o.triage), name(std::move(o.name), alloc), diagnosis(std::move(o.diagnosis), alloc)
+    {
+    }
+
+    std::uint64_t    id;
+    int              triage;
+    std::pmr::string name;
+    std::pmr::string diagnosis;
+};
+
+struct DoctorRecord {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    DoctorRecord(int id, const allocator_type& alloc)
+        : id(id), name(label("Doctor", static_cast<std::uint64_t>(id), alloc)),
+          specialty("general practice / therapy", alloc), freeSlots(alloc)
+    {
+        for (int s = 0; s < 16; ++s)
+            freeSlots.push_back(s * 15);
+    }
+
+    int                   id;
+    std::pmr::string      name;
+    std::pmr::string      specialty;
+    std::pmr::vector<int> freeSlots;
+};
+
+struct VisitRecord {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    VisitRecord(const PatientRecord& patient, const DoctorRecord& doctor, const allocator_type& alloc)
+        : patient(&patient), doctor(&doctor), room("examination room, 2nd floor", alloc)
+    {
+    }
+
+    const PatientRecord* patient;
+    const DoctorRecord*  doctor;
+    std::pmr::string     room;
+};
+
+// Очередь и построение графа запроса; память под граф даёт наследник
+class QueueDriver {
+public:
+    void enqueue(std::uint64_t patientId, int triage, double)
+    {
+        queue_.push(patientId, Key{triage, next_++});
+    }
+
+    bool cancel(std::uint64_t patientId, double) { return queue_.erase(patientId); }
+
+    std::uint64_t checksum() const { return checksum_; }
+
+protected:
+    std::optional<std::uint64_t> dequeue(int doctor, std::pmr::memory_resource* resource)
+    {
+        if (queue_.empty())
+            return std::nullopt;
+        const std::uint64_t id = queue_.top().id;
+        const int triage = queue_.top().priority.first;
+
+        std::pmr::vector<PatientRecord> candidates(resource);
+        candidates.reserve(kCandidates);
+        for (int k = 0; k < kCandidates; ++k)
+            candidates.emplace_back(id + static_cast<std::uint64_t>(k), triage);
+        const DoctorRecord who(doctor, resource);
+        const VisitRecord visit(candidates.front(), who, resource);
+        checksum_ += visit.patient->name.size() + visit.doctor->freeSlots.size() + visit.room.size();
+
+        queue_.pop();
+        return id;
+    }
+
+private:
+    using Key = std::pair<int, std::uint64_t>; // (триаж, номер прихода)
+
+    IndexedDaryHeap<std::uint64_t, Key> queue_;
+    std::uint64_t                       next_ = 0;
+    std::uint64_t                       checksum_ = 0;
+};
+
+struct HeapDriver : QueueDriver {
+    std::optional<std::uint64_t> dequeue(int doctor, double)
+    {
+        return QueueDriver::dequeue(doctor, std::pmr::new_delete_resource());
+    }
+};
+
+// Арена создаётся до прогона и переиспользуется: на запрос — только release()
+struct ArenaDriver : QueueDriver {
+    std::optional<std::uint64_t> dequeue(int doctor, double)
+    {
+        ArenaScope scope(arena);
+        return QueueDriver::dequeue(doctor, arena.resource());
+    }
+
+    RequestArena arena;
+};
+
+struct Row {
+    const char*           name;
+    LoadSimulator::Report report;
+};
+
+void summary(Row* rows, std::size_t count)
+{
+    std::printf("\n%-12s %12s %10s %12s %14s\n", "driver", "allocations", "per op", "dequeue p99", "throughput");
+    for (std::size_t i = 0; i < count; ++i) {
+        LoadSimulator::Report& r = rows[i].report;
+        const std::size_t ops = r.enqueue.count() + r.dequeue.count() + r.cancel.count();
+        std::printf("%-12s %12llu %10.3f %10lldns %10.0f op/s\n", rows[i].name,
+                    static_cast<unsigned long long>(r.allocations),
+                    ops ? static_cast<double>(r.allocations) / static_cast<double>(ops) : 0.0,
+                    static_cast<long long>(r.dequeue.percentile(0.99)), r.ops_per_second());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    LoadSimulator::Config config;
+    if (argc > 1)
+        config.arrivalsPerMinute = std::atof(argv[1]);
+    if (argc > 2)
+        config.doctors = std::atoi(argv[2]);
+    if (argc > 3)
+        config.durationMinutes = std::atof(argv[3]) * 60.0;
+    if (argc > 4)
+        config.seed = std::strtoull(argv[4], nullptr, 10);
+    if (argc > 5)
+        config.cancelProbability = std::atof(argv[5]);
+    if (argc > 6)
+        config.meanPatienceMinutes = std::atof(argv[6]);
+    config.allocationCounter = allocation_count;
+
+    std::cout << "arrivals/min=" << config.arrivalsPerMinute << " doctors=" << config.doctors
+              << " hours=" << config.durationMinutes / 60.0 << " load=" << config.utilization()
+              << " cancel=" << config.cancelProbability << " patience=" << config.meanPatienceMinutes << "min\n";
+    if (config.utilization() >= 1.0)
+        std::cout << "warning: load >= 1, the queue grows without bound\n";
+
+    const LoadSimulator sim(config);
+    const auto trace = sim.generate();
+
+    HeapDriver  heap;
+    ArenaDriver arena;
+    Row rows[] = {{"HeapDriver", sim.run(heap, trace)}, {"ArenaDriver", sim.run(arena, trace)}};
+    for (Row& row : rows) {
+        std::cout << "\n[" << row.name << "]\n";
+        row.report.print(std::cout);
+    }
+    summary(rows, 2);
+    if (heap.checksum() != arena.checksum())
+        std::cout << "warning: drivers built different request graphs\n";
+    std::cout << "arena upstream allocations: " << arena.arena.upstream_allocations() << '\n';
+}
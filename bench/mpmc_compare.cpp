@@ -0,0 +1,114 @@
+// MpmcRingBuffer против FIFO на std::mutex + std::deque при росте числа
+// потоков: N производителей и N потребителей, N = 1, 2, 4, ..., 64.
+// Производители кладут по items / N элементов, потребители забирают, пока
+// не разобрано всё; меряется пропускная способность (млн операций/с,
+// push и pop вместе). Кольцо ограничено capacity — полный буфер
+// производитель пережидает через yield, пустой потребитель — так же.
+//
+//   mpmc_compare [items] [capacity]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "MpmcRingBuffer.h"
+
+namespace {
+
+class MutexDeque {
+public:
+    explicit MutexDeque(std::size_t) {}
+
+    bool try_push(std::uint64_t v)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(v);
+        return true;
+    }
+
+    std::optional<std::uint64_t> try_pop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty())
+            return std::nullopt;
+        const std::uint64_t v = items_.front();
+        items_.pop_front();
+        return v;
+    }
+
+private:
+    std::mutex                mutex_;
+    std::deque<std::uint64_t> items_;
+};
+
+// Млн операций/с; sum проверяет, что ничего не потерялось
+template <typename Queue>
+double run(int threads, std::uint64_t items, std::size_t capacity)
+{
+    Queue q(capacity);
+    const std::uint64_t perProducer = items / static_cast<std::uint64_t>(threads);
+    const std::uint64_t total = perProducer * static_cast<std::uint64_t>(threads);
+    std::atomic<std::uint64_t> consumed{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> pool;
+    for (int p = 0; p < threads; ++p)
+        pool.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            const std::uint64_t base = static_cast<std::uint64_t>(p) * perProducer;
+            for (std::uint64_t i = 0; i < perProducer; ++i)
+                while (!q.try_push(base + i))
+                    std::this_thread::yield();
+        });
+    for (int c = 0; c < threads; ++c)
+        pool.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            std::uint64_t local = 0;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (const auto v = q.try_pop()) {
+                    local += *v;
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            sum.fetch_add(local, std::memory_order_relaxed);
+        });
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& t : pool)
+        t.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (sum.load() != total * (total - 1) / 2)
+        std::printf("warning: items lost or duplicated\n");
+    return 2.0 * static_cast<double>(total) / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::uint64_t items    = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t   capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+    std::printf("%llu items, ring capacity %zu, %u hardware threads\n", static_cast<unsigned long long>(items),
+                capacity, std::thread::hardware_concurrency());
+    std::printf("%8s %14s %14s\n", "threads", "ring Mops/s", "mutex Mops/s");
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        const double ring  = run<MpmcRingBuffer<std::uint64_t>>(threads, items, capacity);
+        const double mutex = run<MutexDeque>(threads, items, capacity);
+        std::printf("%4dx%-3d %14.2f %14.2f\n", threads, threads, ring, mutex);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Счётчик обращений к глобальному operator new для бенчмарков.
+//
+// allocation_count() можно вызывать из любого места; реальные цифры он
+// отдаёт, только если в программу подменён operator new: ровно в одном
+// .cpp (main бенчмарка) перед включением этого заголовка
+//   #define ALLOCATION_COUNTER_INSTALL
+// В остальных сборках счётчик просто стоит на нуле.
+namespace alloc_count {
+
+inline std::atomic<std::uint64_t>& counter()
+{
+    static std::atomic<std::uint64_t> calls{0};
+    return calls;
+}
+
+} // namespace alloc_count
+
+inline std::uint64_t allocation_count()
+{
+    return alloc_count::counter().load(std::memory_order_relaxed);
+}
+
+#ifdef ALLOCATION_COUNTER_INSTALL
+
+// Остальные формы (массивы, nothrow) по умолчанию вызывают эти
+void* operator new(std::size_t size)
+{
+    alloc_count::counter().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    alloc_count::counter().fetch_add(1, std::memory_order_relaxed);
+    const auto a = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(a, ((size ? size : 1) + a - 1) / a * a))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif
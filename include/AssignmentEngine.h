@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Оптимальное назначение пациентов врачам (кратчайшие увеличивающие пути, O(n^2 m)
+// в худшем случае, на практике заметно быстрее).
+// Раз в тик собирается пачка ожидающих пациентов и свободных врачей, для
+// каждой пары считается стоимость, и ищется назначение с минимальной
+// суммарной стоимостью вместо жадного "первый свободный врач".
+//
+// Пары, которые назначать нельзя (не та специальность), помечаются
+// AssignmentEngine::kForbidden и в ответ не попадают.
+class AssignmentEngine {
+public:
+    static constexpr double kForbidden = std::numeric_limits<double>::infinity();
+
+    // Веса для стоимости пары пациент–врач: чем срочнее пациент и чем дольше
+    // он ждёт, тем дешевле его назначить (тем выгоднее взять его первым).
+    struct Weights {
+        double triage  = 100.0; // за уровень триажа
+        double wait    = 1.0;   // за минуту ожидания
+        double service = 0.5;   // за минуту ожидаемого приёма у этого врача
+    };
+
+    // triage — уровень, где меньший срочнее (1 — немедленно), как и во всей
+    // очереди: каждый уровень вниз по срочности дорожает на w.triage
+    static double pair_cost(const Weights& w, bool specialtyMatches, int triage,
+                            double waitMinutes, double expectedServiceMinutes)
+    {
+        if (!specialtyMatches)
+            return kForbidden;
+        return w.service * expectedServiceMinutes + w.triage * triage - w.wait * waitMinutes;
+    }
+
+    // cost — матрица rows x cols по строкам (пациенты x врачи).
+    // Возвращает для каждой строки номер столбца или -1, если строка не назначена.
+    // Сначала максимизируется число допустимых назначений, затем минимизируется стоимость.
+    static std::vector<int> solve(const std::vector<double>& cost, std::size_t rows, std::size_t cols)
+    {
+        if (cost.size() != rows * cols)
+            throw std::invalid_argument("AssignmentEngine: cost matrix size mismatch");
+        std::vector<int> result(rows, -1);
+        if (rows == 0 || cols == 0)
+            return result;
+
+        // Алгоритм идёт по меньшей стороне: строк не больше, чем столбцов.
+        // Транспонированная матрица копируется, чтобы проход по строке был подряд в памяти.
+        const bool transposed = rows > cols;
+        const std::size_t n = transposed ? cols : rows;
+        const std::size_t m = transposed ? rows : cols;
+        std::vector<double> flipped;
+        const double* c = cost.data();
+        if (transposed) {
+            flipped.resize(n * m);
+            for (std::size_t i = 0; i < rows; ++i)
+                for (std::size_t j = 0; j < cols; ++j)
+                    flipped[j * rows + i] = cost[i * cols + j];
+            c = flipped.data();
+        }
+
+        // Обычно каждая строка находит допустимый столбец. Если какая-то не
+        // нашла, решаем заново, дав каждой строке свой фиктивный столбец «не
+        // назначена» со штрафом больше любого выигрыша по допустимым парам.
+        std::vector<std::ptrdiff_t> col4row;
+        if (!augment<false>(c, n, m, 0.0, col4row)) {
+            double finiteMax = 0.0;
+            for (std::size_t k = 0; k < n * m; ++k)
+                if (c[k] != kForbidden && std::abs(c[k]) > finiteMax)
+                    finiteMax = std::abs(c[k]);
+            augment<true>(c, n, m, (2.0 * finiteMax + 1.0) * static_cast<double>(n + 1), col4row);
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::ptrdiff_t j = col4row[i];
+            if (j < 0 || static_cast<std::size_t>(j) >= m)
+                continue;
+            const std::size_t row = transposed ? static_cast<std::size_t>(j) : i;
+            const std::size_t col = transposed ? i : static_cast<std::size_t>(j);
+            result[row] = static_cast<int>(col);
+        }
+        return result;
+    }
+
+    // Удобная обёртка: cost(patient, doctor) -> double (или kForbidden)
+    template <typename Patients, typename Doctors, typename CostFn>
+    static std::vector<int> assign(const Patients& patients, const Doctors& doctors, CostFn&& costFn)
+    {
+        const std::size_t rows = patients.size();
+        const std::size_t cols = doctors.size();
+        std::vector<double> cost(rows * cols);
+        std::size_t r = 0;
+        for (const auto& patient : patients) {
+            std::size_t c = 0;
+            for (const auto& doctor : doctors)
+                cost[r * cols + c++] = costFn(patient, doctor);
+            ++r;
+        }
+        return solve(cost, rows, cols);
+    }
+
+private:
+    // Кратчайшие увеличивающие пути (схема Jonker–Volgenant, как в LAPJV и
+    // scipy linear_sum_assignment) по плоской матрице n x m, n <= m. Для каждой
+    // строки — Дейкстра по приведённым стоимостям с остановкой на первом
+    // свободном столбце; потенциалы обновляются только у просмотренных.
+    // Запрещённые пары просто не релаксируются. WithDummies добавляет столбцы
+    // m..m+n-1: столбец m+i доступен только строке i по цене dummyCost.
+    // false — какой-то строке некуда встать (только без фиктивных столбцов).
+    template <bool WithDummies>
+    static bool augment(const double* c, std::size_t n, std::size_t m, double dummyCost,
+                        std::vector<std::ptrdiff_t>& col4row)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const std::size_t cols = WithDummies ? m + n : m;
+
+        std::vector<double>         u(n, 0.0), v(cols, 0.0), dist(cols);
+        std::vector<std::ptrdiff_t> row4col(cols, -1), path(cols, -1);
+        std::vector<char>           done(cols);
+        std::vector<std::size_t>    scannedRows, scannedCols;
+        scannedRows.reserve(n);
+        scannedCols.reserve(cols);
+        col4row.assign(n, -1);
+
+        std::vector<std::size_t> freeRows;
+        if (!WithDummies && n == m) {
+            initSquare(c, n, u, v, col4row, row4col, freeRows);
+        } else {
+            freeRows.resize(n);
+            for (std::size_t i = 0; i < n; ++i)
+                freeRows[i] = i;
+        }
+
+        for (std::size_t cur : freeRows) {
+            std::fill(dist.begin(), dist.end(), inf);
+            std::fill(done.begin(), done.end(), 0);
+            scannedRows.clear();
+            scannedCols.clear();
+
+            std::size_t i = cur;
+            double minVal = 0.0;
+            std::ptrdiff_t sink = -1;
+            while (sink < 0) {
+                scannedRows.push_back(i);
+                const double* row = c + i * m;
+                const double base = minVal - u[i];
+                double lowest = inf;
+                std::size_t best = cols;
+                // Столбцы подряд, а не по списку оставшихся: доступ к памяти
+                // последовательный. Запрещённая пара даёт r = inf и не релаксируется.
+                for (std::size_t j = 0; j < m; ++j) {
+                    if (done[j])
+                        continue;
+                    const double r = base + row[j] - v[j];
+                    if (r < dist[j]) {
+                        dist[j] = r;
+                        path[j] = static_cast<std::ptrdiff_t>(i);
+                    }
+                    // при равенстве предпочитаем свободный столбец — путь короче
+                    if (dist[j] < lowest || (dist[j] == lowest && row4col[j] < 0)) {
+                        lowest = dist[j];
+                        best = j;
+                    }
+                }
+                if constexpr (WithDummies) {
+                    const std::size_t own = m + i;
+                    if (!done[own] && base + dummyCost - v[own] < dist[own]) {
+                        dist[own] = base + dummyCost - v[own];
+                        path[own] = static_cast<std::ptrdiff_t>(i);
+                    }
+                    for (std::size_t j = m; j < cols; ++j)
+                        if (!done[j] && (dist[j] < lowest || (dist[j] == lowest && row4col[j] < 0))) {
+                            lowest = dist[j];
+                            best = j;
+                        }
+                }
+                if (lowest == inf)
+                    return false;
+                minVal = lowest;
+                const std::size_t j = best;
+                done[j] = 1;
+                scannedCols.push_back(j);
+                if (row4col[j] < 0)
+                    sink = static_cast<std::ptrdiff_t>(j);
+                else
+                    i = static_cast<std::size_t>(row4col[j]);
+            }
+
+            u[cur] += minVal;
+            for (std::size_t r : scannedRows)
+                if (r != cur)
+                    u[r] += minVal - dist[static_cast<std::size_t>(col4row[r])];
+            for (std::size_t j : scannedCols)
+                v[j] -= minVal - dist[j];
+
+            for (std::ptrdiff_t j = sink;;) {
+                const auto r = static_cast<std::size_t>(path[static_cast<std::size_t>(j)]);
+                row4col[static_cast<std::size_t>(j)] = static_cast<std::ptrdiff_t>(r);
+                std::swap(col4row[r], j);
+                if (r == cur)
+                    break;
+            }
+        }
+        return true;
+    }
+
+    // Начальное приближение Jonker–Volgenant для квадратной матрицы: редукция
+    // столбцов, перенос редукции и два прохода увеличивающей редукции строк.
+    // Оставляет частичное назначение, где каждая назначенная строка стоит в
+    // минимуме c[i][j] - v[j], и двойственные u, v, допустимые для поиска путей.
+    // Свободные строки — в freeRows. Запрещённые пары в минимумы не попадают,
+    // поэтому потенциалы остаются конечными.
+    static void initSquare(const double* c, std::size_t n, std::vector<double>& u, std::vector<double>& v,
+                           std::vector<std::ptrdiff_t>& col4row, std::vector<std::ptrdiff_t>& row4col,
+                           std::vector<std::size_t>& freeRows)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        std::vector<unsigned> matches(n, 0);
+
+        // Редукция столбцов: v[j] — минимум столбца. Минимумы собираются проходом
+        // по строкам (память подряд); при равенстве побеждает последняя строка.
+        std::vector<std::size_t> argmin(n, 0);
+        std::fill(v.begin(), v.end(), inf);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double* row = c + i * n;
+            for (std::size_t j = 0; j < n; ++j)
+                if (row[j] <= v[j]) {
+                    v[j] = row[j];
+                    argmin[j] = i;
+                }
+        }
+        // Назначения в обратном порядке столбцов, как у JV
+        for (std::size_t j = n; j-- > 0;) {
+            const double low = v[j];
+            if (low == inf) {
+                v[j] = 0.0;
+                continue;
+            }
+            const std::size_t imin = argmin[j];
+            if (++matches[imin] == 1) {
+                col4row[imin] = static_cast<std::ptrdiff_t>(j);
+                row4col[j] = static_cast<std::ptrdiff_t>(imin);
+            } else if (low < v[static_cast<std::size_t>(col4row[imin])]) {
+                row4col[static_cast<std::size_t>(col4row[imin])] = -1;
+                col4row[imin] = static_cast<std::ptrdiff_t>(j);
+                row4col[j] = static_cast<std::ptrdiff_t>(imin);
+            }
+        }
+
+        // Перенос редукции: строка с единственным минимумом удешевляет свой столбец
+        std::vector<std::size_t> pending;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (matches[i] == 0) {
+                pending.push_back(i);
+                continue;
+            }
+            if (matches[i] != 1)
+                continue;
+            const auto j1 = static_cast<std::size_t>(col4row[i]);
+            double low = inf;
+            for (std::size_t j = 0; j < n; ++j)
+                if (j != j1 && c[i * n + j] - v[j] < low)
+                    low = c[i * n + j] - v[j];
+            if (low != inf)
+                v[j1] -= low;
+        }
+
+        // Увеличивающая редукция строк: свободная строка забирает свой минимум,
+        // вытесняя прежнего владельца, и отодвигает столбец на разницу со вторым минимумом
+        // Повторные заходы вытесненных строк ограничены: при недопустимой
+        // задаче (строк больше, чем достижимых столбцов) они шли бы по кругу.
+        for (int pass = 0; pass < 2; ++pass) {
+            std::size_t k = 0;
+            const std::size_t count = pending.size();
+            std::size_t kept = 0;
+            std::size_t retries = 2 * n;
+            while (k < count) {
+                const std::size_t i = pending[k++];
+                double umin = inf, usub = inf;
+                std::size_t j1 = 0, j2 = 0;
+                for (std::size_t j = 0; j < n; ++j) {
+                    const double h = c[i * n + j] - v[j];
+                    if (h < usub) {
+                        if (h >= umin) {
+                            usub = h;
+                            j2 = j;
+                        } else {
+                            usub = umin;
+                            j2 = j1;
+                            umin = h;
+                            j1 = j;
+                        }
+                    }
+                }
+                if (umin == inf) {
+                    pending[kept++] = i; // строке некуда встать — её судьбу решит поиск путей
+                    continue;
+                }
+                std::ptrdiff_t i0 = row4col[j1];
+                const bool strict = umin < usub && usub != inf;
+                if (strict)
+                    v[j1] -= usub - umin;
+                else if (i0 >= 0 && usub != inf) {
+                    j1 = j2;
+                    i0 = row4col[j2];
+                }
+                col4row[i] = static_cast<std::ptrdiff_t>(j1);
+                row4col[j1] = static_cast<std::ptrdiff_t>(i);
+                if (i0 >= 0) {
+                    col4row[static_cast<std::size_t>(i0)] = -1;
+                    if (strict && retries > 0) {
+                        --retries;
+                        pending[--k] = static_cast<std::size_t>(i0);
+                    }
+                    else
+                        pending[kept++] = static_cast<std::size_t>(i0);
+                }
+            }
+            pending.resize(kept);
+        }
+        freeRows = std::move(pending);
+
+        // u — минимум приведённой стоимости строки: назначенные пары становятся точными
+        for (std::size_t i = 0; i < n; ++i) {
+            double low = inf;
+            for (std::size_t j = 0; j < n; ++j)
+                low = std::min(low, c[i * n + j] - v[j]);
+            u[i] = low == inf ? 0.0 : low;
+        }
+    }
+};
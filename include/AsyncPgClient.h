@@ -0,0 +1,476 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <libpq-fe.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Неблокирующий клиент Postgres поверх асинхронного API libpq.
+// Держит пул соединений в неблокирующем режиме и один поток событий на
+// epoll: запрос уходит через PQsendQueryParams, ответ собирается по
+// готовности сокета (PQconsumeInput / PQisBusy / PQgetResult). Установка
+// и восстановление соединений тоже идут через epoll (PQconnectStart /
+// PQresetStart + *Poll): конструктор не ждёт сервер, а запросы, пришедшие
+// раньше первого готового соединения, просто ждут в очереди.
+//
+// Соединение, которое не удалось установить или восстановить, не выбывает
+// из пула: следующая попытка — через паузу 100 мс, удваивающуюся до 5 с
+// (как в ChangeListener), а ждёт её тот же epoll_wait по таймауту.
+// Очередь запросов отклоняется только пока ни одно соединение не готово и
+// не подключается — то есть все ждут повторной попытки.
+//
+// На соединении выполняется один запрос за раз, так что параллелизм на
+// сервере равен размеру пула; остальные запросы ждут в общей очереди FIFO
+// (queued()), не занимая потоков. Конвейерный режим libpq не используется:
+// он экономит круговые задержки, но запросы одного соединения всё равно
+// выполняются одним бэкендом последовательно, а ошибка в конвейере
+// обрывает соседние запросы. Если очередь растёт — увеличивайте пул.
+//
+// Колбэки вызываются в потоке событий — в них нельзя блокироваться.
+class AsyncPgClient {
+public:
+    struct ResultDeleter {
+        void operator()(PGresult* r) const { PQclear(r); }
+    };
+    using Result   = std::unique_ptr<PGresult, ResultDeleter>;
+    using Params   = std::vector<std::optional<std::string>>; // nullopt — SQL NULL
+    using Callback = std::function<void(Result result, std::string error)>;
+
+    class Error : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    AsyncPgClient(std::string conninfo, std::size_t connections)
+        : conninfo_(std::move(conninfo))
+    {
+        if (connections == 0)
+            throw std::invalid_argument("AsyncPgClient: at least one connection is required");
+
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wakeFd_  = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epollFd_ < 0 || wakeFd_ < 0) {
+            closeFds();
+            throw Error("AsyncPgClient: epoll/eventfd setup failed");
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kWakeTag;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+
+        try {
+            for (std::size_t i = 0; i < connections; ++i) {
+                conns_.push_back(std::make_unique<Conn>());
+                if (!start(*conns_.back(), i))
+                    throw Error("AsyncPgClient: connect failed: " + lastError_);
+            }
+        } catch (...) {
+            for (auto& c : conns_)
+                if (c->pg)
+                    PQfinish(c->pg);
+            closeFds();
+            throw;
+        }
+
+        loop_ = std::thread([this] { run(); });
+    }
+
+    AsyncPgClient(const AsyncPgClient&)            = delete;
+    AsyncPgClient& operator=(const AsyncPgClient&) = delete;
+
+    // Незавершённые запросы получают ошибку "client stopped"
+    ~AsyncPgClient()
+    {
+        stopping_ = true;
+        wake();
+        loop_.join();
+        for (auto& c : conns_)
+            if (c->pg)
+                PQfinish(c->pg);
+        closeFds();
+    }
+
+    void query(std::string sql, Params params, Callback callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(Request{std::move(sql), std::move(params), std::move(callback)});
+        }
+        wake();
+    }
+
+    std::future<Result> query(std::string sql, Params params = {})
+    {
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::future<Result> future = promise->get_future();
+        query(std::move(sql), std::move(params), [promise](Result result, std::string error) {
+            if (error.empty())
+                promise->set_value(std::move(result));
+            else
+                promise->set_exception(std::make_exception_ptr(Error(error)));
+        });
+        return future;
+    }
+
+    std::size_t connections() const { return conns_.size(); }
+
+    // Запросы, ещё не отданные соединению
+    std::size_t queued() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::uint64_t kWakeTag = UINT64_MAX;
+    static constexpr std::chrono::milliseconds kMinBackoff{100};
+    static constexpr std::chrono::milliseconds kMaxBackoff{5000};
+
+    struct Request {
+        std::string sql;
+        Params      params;
+        Callback    callback;
+    };
+
+    enum class State { Connecting, Resetting, Ready, Backoff };
+
+    struct Conn {
+        PGconn*                   pg = nullptr; // nullptr — ждёт повторной попытки (Backoff)
+        State                     state = State::Connecting;
+        Clock::time_point         retryAt;
+        std::chrono::milliseconds backoff = kMinBackoff; // пауза перед следующей попыткой
+        int                       fd = -1;      // сокет, зарегистрированный в epoll
+        std::uint32_t             events = 0;
+        std::optional<Request>    current;
+        Result                    result;
+        std::string               error;
+    };
+
+    // false (причина — в lastError_) — только неразборчивый conninfo или
+    // нехватка памяти; недоступный сервер выяснится уже в потоке событий
+    bool start(Conn& c, std::size_t index)
+    {
+        c.pg = PQconnectStart(conninfo_.c_str());
+        if (!c.pg) {
+            lastError_ = "out of memory";
+            return false;
+        }
+        if (PQstatus(c.pg) == CONNECTION_BAD) {
+            lastError_ = PQerrorMessage(c.pg);
+            PQfinish(c.pg);
+            c.pg = nullptr;
+            return false;
+        }
+        c.state = State::Connecting;
+        watch(c, index, EPOLLOUT); // опрос начинается так, будто *Poll вернул WRITING
+        return true;
+    }
+
+    // Шаг установки соединения по готовности сокета
+    void poll(Conn& c, std::size_t index)
+    {
+        const PostgresPollingStatusType st =
+            c.state == State::Resetting ? PQresetPoll(c.pg) : PQconnectPoll(c.pg);
+        switch (st) {
+        case PGRES_POLLING_READING:
+            watch(c, index, EPOLLIN);
+            return;
+        case PGRES_POLLING_WRITING:
+            watch(c, index, EPOLLOUT);
+            return;
+        case PGRES_POLLING_OK:
+            if (PQsetnonblocking(c.pg, 1) == 0) {
+                c.state = State::Ready;
+                c.backoff = kMinBackoff;
+                watch(c, index, EPOLLIN);
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+        drop(c);
+    }
+
+    // libpq может сменить сокет по ходу подключения (несколько хостов,
+    // повтор без SSL) — тогда старый снимаем, новый добавляем
+    void watch(Conn& c, std::size_t index, std::uint32_t events)
+    {
+        const int fd = PQsocket(c.pg);
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = index;
+        if (fd != c.fd) {
+            if (c.fd >= 0)
+                ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, c.fd, nullptr);
+            c.fd = fd;
+            if (fd >= 0)
+                ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+        } else if (events != c.events || c.state != State::Ready) {
+            // пока идёт подключение, сокет мог быть закрыт и открыт под тем же
+            // номером — такой epoll уже забыл, и MOD вернёт ENOENT
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) != 0 && errno == ENOENT)
+                ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+        }
+        c.events = events;
+    }
+
+    // Соединение закрывается, слот ждёт следующей попытки
+    void drop(Conn& c)
+    {
+        lastError_ = PQerrorMessage(c.pg);
+        if (c.fd >= 0)
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, c.fd, nullptr);
+        PQfinish(c.pg);
+        c.pg = nullptr;
+        c.fd = -1;
+        c.events = 0;
+        backoff(c);
+    }
+
+    void backoff(Conn& c)
+    {
+        c.state = State::Backoff;
+        c.retryAt = Clock::now() + c.backoff;
+        c.backoff = std::min(c.backoff * 2, kMaxBackoff);
+    }
+
+    // Таймаут epoll_wait до ближайшей повторной попытки; -1 — ждать нечего
+    int retryTimeout() const
+    {
+        std::optional<Clock::time_point> next;
+        for (const auto& c : conns_)
+            if (c->state == State::Backoff && (!next || c->retryAt < *next))
+                next = c->retryAt;
+        if (!next)
+            return -1;
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(*next - Clock::now());
+        return static_cast<int>(std::max<std::chrono::milliseconds::rep>(left.count(), 0));
+    }
+
+    void retryDue()
+    {
+        const Clock::time_point now = Clock::now();
+        for (std::size_t i = 0; i < conns_.size(); ++i) {
+            Conn& c = *conns_[i];
+            if (c.state == State::Backoff && c.retryAt <= now && !start(c, i))
+                backoff(c);
+        }
+    }
+
+    void wake()
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+    }
+
+    void closeFds()
+    {
+        if (epollFd_ >= 0)
+            ::close(epollFd_);
+        if (wakeFd_ >= 0)
+            ::close(wakeFd_);
+        epollFd_ = wakeFd_ = -1;
+    }
+
+    void run()
+    {
+        std::vector<epoll_event> events(conns_.size() + 1);
+        while (!stopping_) {
+            const int n = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), retryTimeout());
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.u64 == kWakeTag) {
+                    std::uint64_t drained = 0;
+                    [[maybe_unused]] ssize_t r = ::read(wakeFd_, &drained, sizeof(drained));
+                    continue;
+                }
+                Conn& c = *conns_[events[i].data.u64];
+                if (!c.pg)
+                    continue;
+                if (c.state != State::Ready) {
+                    poll(c, events[i].data.u64);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT)
+                    flush(c, events[i].data.u64);
+                if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+                    readable(c, events[i].data.u64);
+            }
+            retryDue();
+            dispatch();
+        }
+        failAll("AsyncPgClient: client stopped");
+    }
+
+    // Раздаёт ожидающие запросы свободным соединениям
+    void dispatch()
+    {
+        bool alive = false;
+        for (const auto& c : conns_)
+            alive = alive || c->state != State::Backoff;
+        if (!alive) {
+            failAll("AsyncPgClient: no live connections: " + lastError_);
+            return;
+        }
+
+        for (std::size_t i = 0; i < conns_.size(); ++i) {
+            Conn& c = *conns_[i];
+            if (c.current || !c.pg || c.state != State::Ready)
+                continue;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (pending_.empty())
+                return;
+            c.current = std::move(pending_.front());
+            pending_.pop_front();
+            lock.unlock();
+
+            send(c, i);
+        }
+    }
+
+    void send(Conn& c, std::size_t index)
+    {
+        const Params& params = c.current->params;
+        std::vector<const char*> values(params.size());
+        for (std::size_t p = 0; p < params.size(); ++p)
+            values[p] = params[p] ? params[p]->c_str() : nullptr;
+
+        if (!PQsendQueryParams(c.pg, c.current->sql.c_str(), static_cast<int>(params.size()), nullptr,
+                               values.data(), nullptr, nullptr, 0)) {
+            c.error = PQerrorMessage(c.pg);
+            complete(c, index);
+            return;
+        }
+        flush(c, index);
+    }
+
+    // В неблокирующем режиме запрос может уйти в сокет не целиком
+    void flush(Conn& c, std::size_t index)
+    {
+        const int rc = PQflush(c.pg);
+        if (rc < 0) {
+            c.error = PQerrorMessage(c.pg);
+            complete(c, index);
+            return;
+        }
+        watch(c, index, EPOLLIN | (rc == 1 ? EPOLLOUT : 0u));
+    }
+
+    void readable(Conn& c, std::size_t index)
+    {
+        if (!PQconsumeInput(c.pg)) {
+            c.error = PQerrorMessage(c.pg);
+            if (c.current)
+                complete(c, index);
+            reconnect(c, index);
+            return;
+        }
+        if (!c.current) {
+            // уведомления и прочий фон без активного запроса нам не нужны
+            while (PGnotify* n = PQnotifies(c.pg))
+                PQfreemem(n);
+            return;
+        }
+
+        while (!PQisBusy(c.pg)) {
+            PGresult* r = PQgetResult(c.pg);
+            if (!r) {
+                complete(c, index);
+                return;
+            }
+            const ExecStatusType status = PQresultStatus(r);
+            if (status == PGRES_FATAL_ERROR || status == PGRES_BAD_RESPONSE) {
+                if (c.error.empty())
+                    c.error = PQresultErrorMessage(r);
+                PQclear(r);
+            } else {
+                c.result.reset(r); // для нескольких операторов остаётся последний результат
+            }
+        }
+    }
+
+    void complete(Conn& c, std::size_t)
+    {
+        Request req = std::move(*c.current);
+        c.current.reset();
+        Result result = std::move(c.result);
+        std::string error = std::move(c.error);
+        c.error.clear();
+        if (!error.empty())
+            result.reset();
+        try {
+            req.callback(std::move(result), std::move(error));
+        } catch (...) {
+        }
+    }
+
+    // Порванное соединение переподключается в фоне, пул тем временем работает
+    // на остальных; если и сброс не удался — повтор по таймеру
+    void reconnect(Conn& c, std::size_t index)
+    {
+        if (!PQresetStart(c.pg)) {
+            drop(c);
+            return;
+        }
+        c.state = State::Resetting;
+        watch(c, index, EPOLLOUT);
+    }
+
+    void failAll(const std::string& why)
+    {
+        for (std::size_t i = 0; i < conns_.size(); ++i) {
+            Conn& c = *conns_[i];
+            if (c.current) {
+                c.error = why;
+                complete(c, i);
+            }
+        }
+        std::deque<Request> rest;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rest.swap(pending_);
+        }
+        for (Request& r : rest) {
+            try {
+                r.callback(Result(), why);
+            } catch (...) {
+            }
+        }
+    }
+
+    std::string                         conninfo_;
+    std::vector<std::unique_ptr<Conn>>  conns_;
+    int                                 epollFd_ = -1;
+    int                                 wakeFd_  = -1;
+    std::string                         lastError_;
+    mutable std::mutex                  mutex_;
+    std::deque<Request>                 pending_;
+    std::atomic<bool>                   stopping_{false};
+    std::thread                         loop_;
+};
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Битовая карта свободных слотов врача: бит 1 — слот свободен.
+// Сетка задаётся началом (секунды Unix), шагом слота и числом слотов,
+// например 5 минут на 90 дней — 25920 бит, 405 слов по 64 бита.
+// Проверка и бронирование работают по словам (маски), поиск первого
+// свободного окна — через ctz по словам, а совместная доступность
+// нескольких врачей — побитовым AND их карт.
+class AvailabilityCalendar {
+public:
+    AvailabilityCalendar(std::int64_t start, std::int64_t slotSeconds, std::size_t slots)
+        : start_(start), slotSeconds_(slotSeconds), slots_(slots), words_((slots + 63) / 64, 0)
+    {
+        if (slotSeconds <= 0)
+            throw std::invalid_argument("AvailabilityCalendar: slot length must be positive");
+    }
+
+    // Карта из готовых слов (снимок, БД): words.size() == (slots + 63) / 64,
+    // биты за последним слотом отбрасываются
+    static AvailabilityCalendar from_words(std::int64_t start, std::int64_t slotSeconds, std::size_t slots,
+                                           std::vector<std::uint64_t> words)
+    {
+        AvailabilityCalendar c(start, slotSeconds, slots);
+        if (words.size() != c.words_.size())
+            throw std::invalid_argument("AvailabilityCalendar: word count does not match the slot count");
+        c.words_ = std::move(words);
+        if (slots % 64 != 0)
+            c.words_.back() &= (std::uint64_t(1) << (slots % 64)) - 1;
+        return c;
+    }
+
+    std::int64_t start() const { return start_; }
+    std::int64_t slot_seconds() const { return slotSeconds_; }
+    std::size_t  slots() const { return slots_; }
+
+    // Слова карты: слот i — бит i % 64 слова i / 64
+    const std::vector<std::uint64_t>& words() const { return words_; }
+
+    // Номер слота, в который попадает момент времени (без проверки границ)
+    std::int64_t slot_of(std::int64_t time) const
+    {
+        const std::int64_t d = time - start_;
+        return d >= 0 ? d / slotSeconds_ : -((-d + slotSeconds_ - 1) / slotSeconds_);
+    }
+
+    std::int64_t time_of(std::size_t slot) const { return start_ + static_cast<std::int64_t>(slot) * slotSeconds_; }
+
+    // Открыть слоты для приёма (рабочие часы)
+    void open(std::size_t first, std::size_t count) { apply(first, count, true); }
+    void close(std::size_t first, std::size_t count) { apply(first, count, false); }
+
+    bool is_free(std::size_t first, std::size_t count) const
+    {
+        if (count == 0 || first + count > slots_ || first + count < first)
+            return false;
+        bool free = true;
+        forEachWord(first, count, [&](std::size_t w, std::uint64_t mask) { free = free && (words_[w] & mask) == mask; });
+        return free;
+    }
+
+    // false — окно занято хотя бы частично, карта не меняется
+    bool book(std::size_t first, std::size_t count)
+    {
+        if (!is_free(first, count))
+            return false;
+        apply(first, count, false);
+        return true;
+    }
+
+    void release(std::size_t first, std::size_t count) { apply(first, count, true); }
+
+    // Первое окно из count подряд свободных слотов, начиная с from
+    std::optional<std::size_t> find_first_free(std::size_t count, std::size_t from = 0) const
+    {
+        if (count == 0 || count > slots_)
+            return std::nullopt;
+
+        std::size_t pos = from;
+        while (pos + count <= slots_) {
+            const std::size_t begin = nextBit(pos, true);
+            if (begin >= slots_ || begin + count > slots_)
+                return std::nullopt;
+            const std::size_t end = nextBit(begin, false); // первый занятый после begin
+            if (end - begin >= count)
+                return begin;
+            pos = end;
+        }
+        return std::nullopt;
+    }
+
+    std::size_t free_count() const
+    {
+        std::size_t n = 0;
+        for (std::uint64_t w : words_)
+            n += static_cast<std::size_t>(__builtin_popcountll(w));
+        return n;
+    }
+
+    // Совместная доступность: AND карт нескольких врачей на одной сетке
+    static AvailabilityCalendar intersect(const std::vector<const AvailabilityCalendar*>& calendars)
+    {
+        if (calendars.empty())
+            throw std::invalid_argument("AvailabilityCalendar: nothing to intersect");
+        AvailabilityCalendar out = *calendars.front();
+        for (std::size_t i = 1; i < calendars.size(); ++i) {
+            const AvailabilityCalendar& c = *calendars[i];
+            if (c.start_ != out.start_ || c.slotSeconds_ != out.slotSeconds_ || c.slots_ != out.slots_)
+                throw std::invalid_argument("AvailabilityCalendar: calendars use different grids");
+            for (std::size_t w = 0; w < out.words_.size(); ++w)
+                out.words_[w] &= c.words_[w];
+        }
+        return out;
+    }
+
+private:
+    // Вызывает fn(word, mask) для каждого слова, задетого диапазоном [first, first + count)
+    template <typename Fn>
+    static void forEachWord(std::size_t first, std::size_t count, Fn&& fn)
+    {
+        std::size_t pos = first;
+        const std::size_t end = first + count;
+        while (pos < end) {
+            const std::size_t w = pos / 64;
+            const unsigned lo = static_cast<unsigned>(pos % 64);
+            const std::size_t take = std::min<std::size_t>(64 - lo, end - pos);
+            const std::uint64_t mask = take == 64 ? ~std::uint64_t(0) : ((std::uint64_t(1) << take) - 1) << lo;
+            fn(w, mask);
+            pos += take;
+        }
+    }
+
+    void apply(std::size_t first, std::size_t count, bool free)
+    {
+        if (first > slots_ || count > slots_ - first)
+            throw std::out_of_range("AvailabilityCalendar: slot range out of bounds");
+        forEachWord(first, count, [&](std::size_t w, std::uint64_t mask) {
+            if (free)
+                words_[w] |= mask;
+            else
+                words_[w] &= ~mask;
+        });
+    }
+
+    // Первая позиция >= pos, где бит равен value; slots_, если такой нет
+    std::size_t nextBit(std::size_t pos, bool value) const
+    {
+        if (pos >= slots_)
+            return slots_;
+        std::size_t w = pos / 64;
+        std::uint64_t bits = (value ? words_[w] : ~words_[w]) & (~std::uint64_t(0) << (pos % 64));
+        while (bits == 0) {
+            if (++w >= words_.size())
+                return slots_;
+            bits = value ? words_[w] : ~words_[w];
+        }
+        const std::size_t found = w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits));
+        return found < slots_ ? found : slots_;
+    }
+
+    std::int64_t               start_;
+    std::int64_t               slotSeconds_;
+    std::size_t                slots_;
+    std::vector<std::uint64_t> words_;
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <libpq-fe.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Подписчик на LISTEN/NOTIFY для точечной инвалидации кэшей Patient и Doctor.
+// Держит собственное соединение (не из DataBaseWorker: LISTEN привязан к
+// сессии), слушает каналы в фоновом потоке и отдаёт payload обработчику
+// канала. Триггеры, которые шлют NOTIFY с id сущности, — в sql/change_notify.sql.
+//
+// Пока соединения не было, уведомления теряются, поэтому после каждого
+// (пере)подключения вызывается on_resync — там кэши нужно сбросить целиком.
+class ChangeListener {
+public:
+    using Handler = std::function<void(const std::string& payload)>;
+    using Resync  = std::function<void()>;
+
+    explicit ChangeListener(std::string conninfo) : conninfo_(std::move(conninfo))
+    {
+        wakeFd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wakeFd_ < 0)
+            throw std::runtime_error("ChangeListener: eventfd failed");
+    }
+
+    ChangeListener(const ChangeListener&)            = delete;
+    ChangeListener& operator=(const ChangeListener&) = delete;
+
+    ~ChangeListener()
+    {
+        stop();
+        ::close(wakeFd_);
+    }
+
+    // Подписки задаются до start()
+    void subscribe(std::string channel, Handler handler)
+    {
+        if (thread_.joinable())
+            throw std::logic_error("ChangeListener: subscribe() after start()");
+        handlers_[std::move(channel)] = std::move(handler);
+    }
+
+    void on_resync(Resync resync)
+    {
+        if (thread_.joinable())
+            throw std::logic_error("ChangeListener: on_resync() after start()");
+        resync_ = std::move(resync);
+    }
+
+    void start()
+    {
+        if (thread_.joinable())
+            return;
+        std::uint64_t drained = 0;
+        [[maybe_unused]] ssize_t n = ::read(wakeFd_, &drained, sizeof(drained));
+        stopping_ = false;
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop()
+    {
+        if (!thread_.joinable())
+            return;
+        stopping_ = true;
+        const std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+        thread_.join();
+    }
+
+    bool connected() const { return connected_.load(std::memory_order_relaxed); }
+
+    // Разбирает payload вида "12" или "12,15,40" (пакет id из одного оператора)
+    static std::vector<long long> parse_ids(const std::string& payload)
+    {
+        std::vector<long long> ids;
+        const char* p = payload.c_str();
+        while (*p) {
+            char* end = nullptr;
+            errno = 0;
+            const long long id = std::strtoll(p, &end, 10);
+            if (end == p)
+                break;
+            if (errno == 0)
+                ids.push_back(id);
+            p = end;
+            while (*p == ',' || *p == ' ')
+                ++p;
+        }
+        return ids;
+    }
+
+    // Привязка канала к кэшу с методом invalidate(id), например LruCache
+    template <typename Cache>
+    void bind(const std::string& channel, Cache& cache)
+    {
+        subscribe(channel, [&cache](const std::string& payload) {
+            for (long long id : parse_ids(payload))
+                cache.invalidate(static_cast<typename Cache::KeyType>(id));
+        });
+    }
+
+private:
+    void run()
+    {
+        auto backoff = std::chrono::milliseconds(100);
+        while (!stopping_) {
+            PGconn* conn = connect();
+            if (!conn) {
+                waitForStop(backoff);
+                backoff = std::min(backoff * 2, std::chrono::milliseconds(5000));
+                continue;
+            }
+            backoff = std::chrono::milliseconds(100);
+
+            connected_ = true;
+            if (resync_)
+                resync_();
+            listen(conn);
+            connected_ = false;
+            PQfinish(conn);
+        }
+    }
+
+    PGconn* connect()
+    {
+        PGconn* conn = PQconnectdb(conninfo_.c_str());
+        if (PQstatus(conn) != CONNECTION_OK) {
+            PQfinish(conn);
+            return nullptr;
+        }
+
+        for (const auto& entry : handlers_) {
+            char* ident = PQescapeIdentifier(conn, entry.first.c_str(), entry.first.size());
+            if (!ident) {
+                PQfinish(conn);
+                return nullptr;
+            }
+            const std::string sql = std::string("LISTEN ") + ident;
+            PQfreemem(ident);
+
+            PGresult* res = PQexec(conn, sql.c_str());
+            const bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+            PQclear(res);
+            if (!ok) {
+                PQfinish(conn);
+                return nullptr;
+            }
+        }
+        return conn;
+    }
+
+    // Возвращается, когда соединение порвалось или попросили остановиться
+    void listen(PGconn* conn)
+    {
+        pollfd fds[2];
+        fds[0] = {PQsocket(conn), POLLIN, 0};
+        fds[1] = {wakeFd_, POLLIN, 0};
+
+        while (!stopping_) {
+            fds[0].revents = fds[1].revents = 0;
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            if (fds[1].revents & POLLIN)
+                return;
+            if (!(fds[0].revents & (POLLIN | POLLERR | POLLHUP)))
+                continue;
+
+            if (!PQconsumeInput(conn) || PQstatus(conn) != CONNECTION_OK)
+                return;
+            while (PGnotify* notify = PQnotifies(conn)) {
+                dispatch(notify->relname, notify->extra ? notify->extra : "");
+                PQfreemem(notify);
+            }
+        }
+    }
+
+    void dispatch(const char* channel, const char* payload)
+    {
+        auto it = handlers_.find(channel);
+        if (it == handlers_.end())
+            return;
+        try {
+            it->second(payload);
+        } catch (...) {
+            // Ошибка обработчика не должна ронять подписчика; на всякий случай
+            // считаем, что инвалидация потеряна, и сбрасываем всё
+            if (resync_)
+                resync_();
+        }
+    }
+
+    void waitForStop(std::chrono::milliseconds timeout)
+    {
+        pollfd fd{wakeFd_, POLLIN, 0};
+        ::poll(&fd, 1, static_cast<int>(timeout.count()));
+    }
+
+    std::string                               conninfo_;
+    std::unordered_map<std::string, Handler>  handlers_;
+    Resync                                    resync_;
+    int                                       wakeFd_ = -1;
+    std::atomic<bool>                         stopping_{false};
+    std::atomic<bool>                         connected_{false};
+    std::thread                               thread_;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "InlineString.h"
+#include "VisitColumns.h"
+
+// Уровень триажа: меньший срочнее, как во всей очереди
+enum class Triage : std::uint8_t {
+    Immediate  = 1,
+    VeryUrgent = 2,
+    Urgent     = 3,
+    Standard   = 4,
+    NonUrgent  = 5,
+};
+
+enum class Sex : std::uint8_t { Unknown = 0, Male = 1, Female = 2 };
+
+// Компактная запись пациента в очереди: строки — InlineString внутри
+// записи, категории — однобайтовые enum. Без аллокаций и тривиально
+// копируется, так что очередь двигает её memcpy, а снимок пишет как есть.
+//
+// Ёмкости — в байтах UTF-8: ФИО до ~30 букв кириллицей, полис ОМС —
+// 16 цифр, код отделения — до 6 символов. Длиннее — std::length_error
+// при присваивании (или InlineString::truncated).
+struct CompactPatient {
+    std::int64_t     id = 0;
+    std::int64_t     arrivedAt = 0; // секунды Unix
+    std::int32_t     doctorId = -1; // -1 — врач ещё не назначен
+    InlineString<62> fullName;
+    InlineString<16> policy;
+    InlineString<6>  department;
+    Triage           triage = Triage::Standard;
+    Sex              sex = Sex::Unknown;
+    VisitStatus      status = VisitStatus::Arrived;
+
+    // Ключ очереди: триаж, затем время прихода
+    std::pair<int, std::int64_t> queue_key() const { return {static_cast<int>(triage), arrivedAt}; }
+};
+
+static_assert(std::is_trivially_copyable_v<CompactPatient>, "CompactPatient must stay trivially copyable");
+static_assert(sizeof(CompactPatient) >= 64 && sizeof(CompactPatient) <= 128,
+              "CompactPatient must stay within 64-128 bytes");
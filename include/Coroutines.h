@@ -0,0 +1,386 @@
+#pragma once
+
+// Корутинный фронтенд поверх блокирующих операций очереди и БД.
+// Обработчик пишется последовательно (co_await), а поток не блокируется:
+// корутины крутятся на однопоточном Scheduler, блокирующие вызовы
+// DataBaseWorker / PatientQueue уходят в BlockingPool через offload(),
+// а запросы AsyncPgClient ждутся через query() без лишних потоков.
+//
+// Требует C++20 — включается опцией PATIENT_QUEUE_CXX20 в сборке.
+#if __cplusplus < 202002L
+#error "Coroutines.h requires C++20 (configure with -DPATIENT_QUEUE_CXX20=ON)"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+template <typename T = void>
+class Task;
+
+namespace coro_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr      error;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            if (auto next = h.promise().continuation)
+                return next;
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter        final_suspend() const noexcept { return {}; }
+    void                unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+} // namespace coro_detail
+
+// Ленивая задача: стартует при первом co_await, по завершении
+// передаёт управление ожидающему (symmetric transfer, без роста стека)
+template <typename T>
+class Task {
+public:
+    struct promise_type : coro_detail::PromiseBase {
+        std::optional<coro_detail::Stored<T>> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+        void return_value(U v)
+        {
+            value.emplace(std::move(v));
+        }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        auto& p = handle_.promise();
+        if (p.error)
+            std::rethrow_exception(p.error);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*p.value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <>
+struct Task<void>::promise_type : coro_detail::PromiseBase {
+    std::optional<std::monostate> value;
+
+    Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    void return_void() {}
+};
+
+// Однопоточный планировщик: все корутины возобновляются в потоке run(),
+// поэтому состояние обработчиков не требует блокировок.
+class Scheduler {
+public:
+    Scheduler() = default;
+    Scheduler(const Scheduler&)            = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Потокобезопасно: так завершения из чужих потоков возвращают корутину сюда
+    void post(std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(h);
+        }
+        cv_.notify_one();
+    }
+
+    // co_await sched.schedule() — продолжить в потоке планировщика
+    auto schedule()
+    {
+        struct Awaiter {
+            Scheduler* s;
+            bool       await_ready() const noexcept { return false; }
+            void       await_suspend(std::coroutine_handle<> h) { s->post(h); }
+            void       await_resume() const noexcept {}
+        };
+        return Awaiter{this};
+    }
+
+    // Запускает обработчик «в фоне»; run() не вернётся, пока он не завершится
+    void spawn(Task<void> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++live_;
+        }
+        detach(this, std::move(task));
+    }
+
+    // Крутит готовые корутины до stop() или завершения всех spawn-задач.
+    // Первое необработанное исключение обработчика пробрасывается наружу.
+    void run()
+    {
+        for (;;) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopped_ || live_ == 0 || !ready_.empty() || error_; });
+                if (error_)
+                    std::rethrow_exception(std::exchange(error_, nullptr));
+                if (ready_.empty())
+                    return;
+                h = ready_.front();
+                ready_.pop_front();
+            }
+            h.resume();
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    struct Detached {
+        struct promise_type {
+            Detached            get_return_object() const noexcept { return {}; }
+            std::suspend_never  initial_suspend() const noexcept { return {}; }
+            std::suspend_never  final_suspend() const noexcept { return {}; }
+            void                return_void() const noexcept {}
+            void                unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    static Detached detach(Scheduler* s, Task<void> task)
+    {
+        co_await s->schedule();
+        std::exception_ptr error;
+        try {
+            co_await task;
+        } catch (...) {
+            error = std::current_exception();
+        }
+        s->finished(error);
+    }
+
+    void finished(std::exception_ptr error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --live_;
+            if (error && !error_)
+                error_ = error;
+        }
+        cv_.notify_all();
+    }
+
+    std::mutex                          mutex_;
+    std::condition_variable             cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::size_t                         live_ = 0;
+    bool                                stopped_ = false;
+    std::exception_ptr                  error_;
+};
+
+// Ожидание результата, который придёт колбэком из другого потока.
+// start(complete) запускает операцию; complete(value) или complete.fail(e)
+// сохраняет результат и возвращает корутину в планировщик.
+template <typename T>
+class CallbackAwaiter {
+public:
+    class Completion {
+    public:
+        template <typename... Args>
+        void operator()(Args&&... args) const
+        {
+            self_->value_.emplace(std::forward<Args>(args)...);
+            self_->scheduler_.post(handle_);
+        }
+
+        void fail(std::exception_ptr e) const
+        {
+            self_->error_ = std::move(e);
+            self_->scheduler_.post(handle_);
+        }
+
+    private:
+        friend class CallbackAwaiter;
+        Completion(CallbackAwaiter* self, std::coroutine_handle<> h) : self_(self), handle_(h) {}
+
+        CallbackAwaiter*        self_;
+        std::coroutine_handle<> handle_;
+    };
+
+    CallbackAwaiter(Scheduler& scheduler, std::function<void(Completion)> start)
+        : scheduler_(scheduler), start_(std::move(start))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { start_(Completion(this, h)); }
+
+    T await_resume()
+    {
+        if (error_)
+            std::rethrow_exception(error_);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*value_);
+    }
+
+private:
+    Scheduler&                              scheduler_;
+    std::function<void(Completion)>         start_;
+    std::optional<coro_detail::Stored<T>>   value_;
+    std::exception_ptr                      error_;
+};
+
+// Пул потоков под блокирующие вызовы (libpqxx в DataBaseWorker, мьютексы очереди)
+class BlockingPool {
+public:
+    explicit BlockingPool(std::size_t threads = 4)
+    {
+        if (threads == 0)
+            threads = 1;
+        for (std::size_t i = 0; i < threads; ++i)
+            workers_.emplace_back([this] { work(); });
+    }
+
+    BlockingPool(const BlockingPool&)            = delete;
+    BlockingPool& operator=(const BlockingPool&) = delete;
+
+    ~BlockingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread& t : workers_)
+            t.join();
+    }
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void work()
+    {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopped_ || !jobs_.empty(); });
+                if (jobs_.empty())
+                    return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex                         mutex_;
+    std::condition_variable            cv_;
+    std::deque<std::function<void()>>  jobs_;
+    std::vector<std::thread>           workers_;
+    bool                               stopped_ = false;
+};
+
+// co_await offload(sched, pool, [&] { return db.loadPatient(id); });
+// Исключение из fn пробрасывается в корутину.
+template <typename Fn>
+auto offload(Scheduler& scheduler, BlockingPool& pool, Fn fn)
+{
+    using R = std::invoke_result_t<Fn&>;
+    return CallbackAwaiter<R>(scheduler, [&pool, fn = std::move(fn)](auto done) mutable {
+        pool.submit([done, fn = std::move(fn)]() mutable {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    fn();
+                    done();
+                } else {
+                    done(fn());
+                }
+            } catch (...) {
+                done.fail(std::current_exception());
+            }
+        });
+    });
+}
+
+// co_await query(sched, client, sql, params) для AsyncPgClient (или совместимого
+// клиента с Result, Params, Error и query(sql, params, callback))
+template <typename Client>
+auto query(Scheduler& scheduler, Client& client, std::string sql, typename Client::Params params = {})
+{
+    using Result = typename Client::Result;
+    return CallbackAwaiter<Result>(
+        scheduler, [&client, sql = std::move(sql), params = std::move(params)](auto done) mutable {
+            client.query(std::move(sql), std::move(params), [done](Result result, std::string error) {
+                if (error.empty())
+                    done(std::move(result));
+                else
+                    done.fail(std::make_exception_ptr(typename Client::Error(error)));
+            });
+        });
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "MpmcRingBuffer.h"
+#include "ShardedQueue.h"
+
+// Бэкенд очереди отделения
+enum class QueueBackend {
+    Triage, // куча с приоритетом — шард ShardedQueue
+    Fifo,   // живая очередь без триажа — lock-free MpmcRingBuffer
+};
+
+// Очереди отделений с бэкендом, выбранным для каждого отделения отдельно.
+// Отделения с триажем — шарды одной ShardedQueue (и могут красть друг у
+// друга), простые FIFO-отделения — по своему MpmcRingBuffer ограниченной
+// ёмкости. Что выгоднее на конкретной машине — см. bench/mpmc_compare.cpp.
+template <typename T, typename Compare = std::greater<T>>
+class DepartmentQueues {
+public:
+    // backends[d] — бэкенд отделения d; fifoCapacity — ёмкость каждой FIFO
+    DepartmentQueues(const std::vector<QueueBackend>& backends, std::size_t fifoCapacity,
+                     Compare compare = Compare())
+    {
+        if (backends.empty())
+            throw std::invalid_argument("DepartmentQueues: at least one department is required");
+
+        std::size_t triage = 0;
+        for (QueueBackend b : backends) {
+            if (b == QueueBackend::Triage) {
+                slots_.push_back(Slot{b, triage++});
+            } else {
+                slots_.push_back(Slot{b, fifos_.size()});
+                fifos_.push_back(std::make_unique<MpmcRingBuffer<T>>(fifoCapacity));
+            }
+        }
+        if (triage > 0)
+            triage_ = std::make_unique<ShardedQueue<T, Compare>>(triage, std::move(compare));
+    }
+
+    std::size_t  department_count() const { return slots_.size(); }
+    QueueBackend backend(std::size_t department) const { return at(department).backend; }
+
+    // false — FIFO отделения заполнена; триажная очередь не ограничена
+    bool push(std::size_t department, T value)
+    {
+        const Slot& s = at(department);
+        if (s.backend == QueueBackend::Fifo)
+            return fifos_[s.index]->try_push(std::move(value));
+        triage_->push(s.index, std::move(value));
+        return true;
+    }
+
+    std::optional<T> pop(std::size_t department)
+    {
+        const Slot& s = at(department);
+        if (s.backend == QueueBackend::Fifo)
+            return fifos_[s.index]->try_pop();
+        return triage_->pop(s.index);
+    }
+
+    // Для триажных отделений — с кражей у других триажных (ShardedQueue::pop_or_steal)
+    template <typename Eligible>
+    std::optional<T> pop_or_steal(std::size_t department, Eligible&& eligible)
+    {
+        const Slot& s = at(department);
+        if (s.backend == QueueBackend::Fifo)
+            return fifos_[s.index]->try_pop();
+        return triage_->pop_or_steal(s.index, std::forward<Eligible>(eligible));
+    }
+
+    // Для FIFO — приблизительный
+    std::size_t size(std::size_t department) const
+    {
+        const Slot& s = at(department);
+        if (s.backend == QueueBackend::Fifo)
+            return fifos_[s.index]->size_approx();
+        return triage_->size(s.index);
+    }
+
+private:
+    struct Slot {
+        QueueBackend backend;
+        std::size_t  index; // номер шарда или FIFO
+    };
+
+    const Slot& at(std::size_t department) const
+    {
+        if (department >= slots_.size())
+            throw std::out_of_range("DepartmentQueues: department index out of range");
+        return slots_[department];
+    }
+
+    std::vector<Slot>                               slots_;
+    std::unique_ptr<ShardedQueue<T, Compare>>       triage_;
+    std::vector<std::unique_ptr<MpmcRingBuffer<T>>> fifos_;
+};
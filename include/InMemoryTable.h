@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Таблица в памяти процесса с хеш-индексами — основа in-memory хранилища
+// вместо Postgres для бенчмарков очереди и герметичных прогонов без БД.
+// Первичный ключ — уникальный, вторичные индексы по целочисленной колонке
+// (doctor_id, patient_id, статус...) — неуникальные.
+//
+// KeyOf — функтор, достающий первичный ключ из строки.
+template <typename Key, typename Row, typename KeyOf, typename Hash = std::hash<Key>>
+class InMemoryTable {
+public:
+    using IndexFn = std::function<std::int64_t(const Row&)>;
+
+    struct Stats {
+        std::uint64_t reads  = 0;
+        std::uint64_t writes = 0;
+    };
+
+    explicit InMemoryTable(KeyOf keyOf = KeyOf()) : keyOf_(std::move(keyOf)) {}
+
+    // Индексы добавляются до первой вставки
+    void add_index(const std::string& name, IndexFn fn)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!rows_.empty())
+            throw std::logic_error("InMemoryTable: add_index() on a non-empty table");
+        indexes_.emplace(name, Index{std::move(fn), {}});
+    }
+
+    // false — строка с таким ключом уже есть
+    bool insert(Row row)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        Key key = keyOf_(row);
+        auto [it, inserted] = rows_.emplace(std::move(key), std::move(row));
+        if (inserted)
+            indexRow(it->first, it->second);
+        return inserted;
+    }
+
+    void upsert(Row row)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        Key key = keyOf_(row);
+        auto it = rows_.find(key);
+        if (it != rows_.end()) {
+            unindexRow(it->first, it->second);
+            it->second = std::move(row);
+        } else {
+            it = rows_.emplace(std::move(key), std::move(row)).first;
+        }
+        indexRow(it->first, it->second);
+    }
+
+    // Изменяет строку на месте; первичный ключ менять нельзя
+    template <typename Fn>
+    bool update(const Key& key, Fn&& fn)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        auto it = rows_.find(key);
+        if (it == rows_.end())
+            return false;
+        Row updated = it->second;
+        fn(updated);
+        if (!(keyOf_(updated) == it->first))
+            throw std::logic_error("InMemoryTable: update() must not change the primary key");
+        unindexRow(it->first, it->second);
+        it->second = std::move(updated);
+        indexRow(it->first, it->second);
+        return true;
+    }
+
+    bool erase(const Key& key)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        auto it = rows_.find(key);
+        if (it == rows_.end())
+            return false;
+        unindexRow(it->first, it->second);
+        rows_.erase(it);
+        return true;
+    }
+
+    std::optional<Row> find(const Key& key) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        auto it = rows_.find(key);
+        if (it == rows_.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    // Все строки, у которых индекс name равен value
+    std::vector<Row> find_by(const std::string& name, std::int64_t value) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        const Index& index = indexAt(name);
+        std::vector<Row> out;
+        auto bucket = index.entries.find(value);
+        if (bucket == index.entries.end())
+            return out;
+        out.reserve(bucket->second.size());
+        for (const Key& key : bucket->second)
+            out.push_back(rows_.at(key));
+        return out;
+    }
+
+    std::size_t count_by(const std::string& name, std::int64_t value) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        const Index& index = indexAt(name);
+        auto bucket = index.entries.find(value);
+        return bucket == index.entries.end() ? 0 : bucket->second.size();
+    }
+
+    // Полный обход (для редких отчётов); fn(const Row&)
+    template <typename Fn>
+    void scan(Fn&& fn) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        for (const auto& entry : rows_)
+            fn(entry.second);
+    }
+
+    std::size_t size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return rows_.size();
+    }
+
+    void clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        rows_.clear();
+        for (auto& index : indexes_)
+            index.second.entries.clear();
+    }
+
+    Stats stats() const
+    {
+        return Stats{reads_.load(std::memory_order_relaxed), writes_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    struct Index {
+        IndexFn                                                             fn;
+        std::unordered_map<std::int64_t, std::unordered_set<Key, Hash>>     entries;
+    };
+
+    const Index& indexAt(const std::string& name) const
+    {
+        auto it = indexes_.find(name);
+        if (it == indexes_.end())
+            throw std::out_of_range("InMemoryTable: unknown index " + name);
+        return it->second;
+    }
+
+    void indexRow(const Key& key, const Row& row)
+    {
+        for (auto& index : indexes_)
+            index.second.entries[index.second.fn(row)].insert(key);
+    }
+
+    void unindexRow(const Key& key, const Row& row)
+    {
+        for (auto& index : indexes_) {
+            auto bucket = index.second.entries.find(index.second.fn(row));
+            if (bucket == index.second.entries.end())
+                continue;
+            bucket->second.erase(key);
+            if (bucket->second.empty())
+                index.second.entries.erase(bucket);
+        }
+    }
+
+    KeyOf                                     keyOf_;
+    mutable std::shared_mutex                 mutex_;
+    std::unordered_map<Key, Row, Hash>        rows_;
+    std::unordered_map<std::string, Index>    indexes_;
+    mutable std::atomic<std::uint64_t>        reads_{0};
+    std::atomic<std::uint64_t>                writes_{0};
+};
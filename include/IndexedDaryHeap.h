@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Индексированная d-арная куча (по умолчанию 4-арная) для PatientQueue.
+// Элементы лежат одним массивом, рядом с каждым хранится id пациента,
+// а отдельная хеш-таблица id -> позиция позволяет менять приоритет и
+// удалять произвольного пациента за O(log n) без перестройки.
+//
+// Как и во всей очереди, меньшее значение приоритета срочнее (триаж 1 —
+// первым): по умолчанию наверху наименьший. Compare — как у
+// std::priority_queue, compare(a, b) == true значит «a уходит позже b».
+template <typename Id,
+          typename Priority,
+          typename Compare = std::greater<Priority>,
+          std::size_t Arity = 4,
+          typename Hash = std::hash<Id>>
+class IndexedDaryHeap {
+    static_assert(Arity >= 2, "IndexedDaryHeap: arity must be at least 2");
+
+public:
+    struct Entry {
+        Priority priority;
+        Id       id;
+    };
+
+    explicit IndexedDaryHeap(Compare compare = Compare()) : compare_(std::move(compare)) {}
+
+    bool        empty() const { return heap_.empty(); }
+    std::size_t size() const { return heap_.size(); }
+    bool        contains(const Id& id) const { return index_.count(id) != 0; }
+
+    void reserve(std::size_t n)
+    {
+        heap_.reserve(n);
+        index_.reserve(n);
+    }
+
+    const Entry& top() const
+    {
+        if (heap_.empty())
+            throw std::out_of_range("IndexedDaryHeap: top() on empty heap");
+        return heap_.front();
+    }
+
+    const Priority& priority(const Id& id) const { return heap_[position(id)].priority; }
+
+    // false, если пациент с таким id уже в куче
+    bool push(const Id& id, Priority priority)
+    {
+        if (!index_.emplace(id, heap_.size()).second)
+            return false;
+        heap_.push_back(Entry{std::move(priority), id});
+        siftUp(heap_.size() - 1);
+        return true;
+    }
+
+    void pop()
+    {
+        if (heap_.empty())
+            throw std::out_of_range("IndexedDaryHeap: pop() on empty heap");
+        removeAt(0);
+    }
+
+    bool erase(const Id& id)
+    {
+        auto it = index_.find(id);
+        if (it == index_.end())
+            return false;
+        removeAt(it->second);
+        return true;
+    }
+
+    void update_priority(const Id& id, Priority priority)
+    {
+        const std::size_t i = position(id);
+        const bool raised = compare_(heap_[i].priority, priority);
+        heap_[i].priority = std::move(priority);
+        if (raised)
+            siftUp(i);
+        else
+            siftDown(i);
+    }
+
+    void clear()
+    {
+        heap_.clear();
+        index_.clear();
+    }
+
+private:
+    std::size_t position(const Id& id) const
+    {
+        auto it = index_.find(id);
+        if (it == index_.end())
+            throw std::out_of_range("IndexedDaryHeap: unknown id");
+        return it->second;
+    }
+
+    void removeAt(std::size_t i)
+    {
+        index_.erase(heap_[i].id);
+        const std::size_t last = heap_.size() - 1;
+        if (i != last) {
+            heap_[i] = std::move(heap_[last]);
+            heap_.pop_back();
+            index_[heap_[i].id] = i;
+            if (i > 0 && compare_(heap_[(i - 1) / Arity].priority, heap_[i].priority))
+                siftUp(i);
+            else
+                siftDown(i);
+        } else {
+            heap_.pop_back();
+        }
+    }
+
+    // Перемещаем "дырку", а не меняем элементы попарно: меньше записей в массив
+    void siftUp(std::size_t i)
+    {
+        Entry moving = std::move(heap_[i]);
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / Arity;
+            if (!compare_(heap_[parent].priority, moving.priority))
+                break;
+            place(i, std::move(heap_[parent]));
+            i = parent;
+        }
+        place(i, std::move(moving));
+    }
+
+    void siftDown(std::size_t i)
+    {
+        const std::size_t n = heap_.size();
+        Entry moving = std::move(heap_[i]);
+        for (;;) {
+            const std::size_t first = i * Arity + 1;
+            if (first >= n)
+                break;
+            const std::size_t end = first + Arity < n ? first + Arity : n;
+
+            std::size_t best = first;
+            for (std::size_t c = first + 1; c < end; ++c)
+                if (compare_(heap_[best].priority, heap_[c].priority))
+                    best = c;
+
+            if (!compare_(moving.priority, heap_[best].priority))
+                break;
+            place(i, std::move(heap_[best]));
+            i = best;
+        }
+        place(i, std::move(moving));
+    }
+
+    void place(std::size_t i, Entry&& e)
+    {
+        heap_[i] = std::move(e);
+        index_[heap_[i].id] = i;
+    }
+
+    std::vector<Entry>                          heap_;
+    std::unordered_map<Id, std::size_t, Hash>   index_;
+    Compare                                     compare_;
+};
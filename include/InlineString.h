@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Строка фиксированной ёмкости, хранящаяся прямо внутри объекта.
+// Ёмкость — в байтах UTF-8: кириллица занимает по два байта на букву.
+// Для имён, кодов полиса, кодов отделений и т.п. в компактных записях
+// Patient: без аллокаций, тривиально копируется (memcpy), а структура из
+// таких полей — POD, который очередь двигает как есть.
+template <std::size_t Capacity>
+class InlineString {
+    static_assert(Capacity > 0 && Capacity < 256, "InlineString: capacity must fit in one byte");
+
+public:
+    constexpr InlineString() noexcept = default;
+
+    // Длиннее Capacity — std::length_error
+    InlineString(std::string_view s) { assign(s); }
+    InlineString(const char* s) : InlineString(std::string_view(s)) {}
+    InlineString(const std::string& s) : InlineString(std::string_view(s)) {}
+
+    // Без исключений: лишнее отрезается, не разрывая UTF-8 символ
+    static InlineString truncated(std::string_view s) noexcept
+    {
+        std::size_t n = s.size();
+        if (n > Capacity) {
+            n = Capacity;
+            while (n > 0 && (static_cast<unsigned char>(s[n]) & 0xC0) == 0x80)
+                --n;
+        }
+        InlineString out;
+        out.copy(s.substr(0, n));
+        return out;
+    }
+
+    void assign(std::string_view s)
+    {
+        if (s.size() > Capacity)
+            throw std::length_error("InlineString: value does not fit");
+        copy(s);
+    }
+
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+    std::size_t size() const noexcept { return size_; }
+    bool        empty() const noexcept { return size_ == 0; }
+    const char* data() const noexcept { return data_; }
+    const char* c_str() const noexcept { return data_; }
+
+    std::string_view view() const noexcept { return std::string_view(data_, size_); }
+    operator std::string_view() const noexcept { return view(); }
+    std::string str() const { return std::string(data_, size_); }
+
+    void clear() noexcept
+    {
+        size_ = 0;
+        data_[0] = '\0';
+    }
+
+    friend bool operator==(const InlineString& a, const InlineString& b) noexcept
+    {
+        return a.size_ == b.size_ && std::memcmp(a.data_, b.data_, a.size_) == 0;
+    }
+    friend bool operator!=(const InlineString& a, const InlineString& b) noexcept { return !(a == b); }
+    friend bool operator<(const InlineString& a, const InlineString& b) noexcept { return a.view() < b.view(); }
+
+    friend std::ostream& operator<<(std::ostream& os, const InlineString& s) { return os << s.view(); }
+
+private:
+    void copy(std::string_view s) noexcept
+    {
+        std::memcpy(data_, s.data(), s.size());
+        // хвост зануляем, чтобы побайтное сравнение/хеш записи были стабильны
+        std::memset(data_ + s.size(), 0, Capacity + 1 - s.size());
+        size_ = static_cast<unsigned char>(s.size());
+    }
+
+    char          data_[Capacity + 1] = {};
+    unsigned char size_ = 0;
+};
+
+namespace std {
+template <std::size_t Capacity>
+struct hash<InlineString<Capacity>> {
+    std::size_t operator()(const InlineString<Capacity>& s) const noexcept
+    {
+        return std::hash<std::string_view>()(s.view());
+    }
+};
+} // namespace std
+
+static_assert(std::is_trivially_copyable<InlineString<15>>::value,
+              "InlineString must stay trivially copyable");
+static_assert(sizeof(InlineString<30>) == 32, "InlineString<N> must occupy N + 2 bytes");
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Набор замеров задержки одной операции с перцентилями
+class LatencyRecorder {
+public:
+    void record(std::chrono::nanoseconds d) { samples_.push_back(d.count()); }
+    void record(std::int64_t value) { samples_.push_back(value); }
+
+    std::size_t count() const { return samples_.size(); }
+    void        reserve(std::size_t n) { samples_.reserve(n); }
+
+    // q в [0, 1]; 0, если замеров нет
+    std::int64_t percentile(double q)
+    {
+        if (samples_.empty())
+            return 0;
+        sort();
+        const auto rank = static_cast<std::size_t>(q * static_cast<double>(samples_.size() - 1) + 0.5);
+        return samples_[std::min(rank, samples_.size() - 1)];
+    }
+
+    double mean() const
+    {
+        if (samples_.empty())
+            return 0.0;
+        long double sum = 0;
+        for (std::int64_t s : samples_)
+            sum += s;
+        return static_cast<double>(sum / samples_.size());
+    }
+
+private:
+    void sort()
+    {
+        if (sorted_ == samples_.size())
+            return;
+        std::sort(samples_.begin(), samples_.end());
+        sorted_ = samples_.size();
+    }
+
+    std::vector<std::int64_t> samples_;
+    std::size_t               sorted_ = 0;
+};
+
+// Дискретно-событийный симулятор нагрузки на очередь пациентов.
+// Генерирует приходы (пуассоновский поток или готовая трасса), уровни
+// триажа, время приёма и отмены, гоняет их через Driver в модельном
+// времени и меряет настоящую (wall-clock) задержку каждого вызова Driver.
+//
+// Driver — любой тип с методами:
+//   void enqueue(std::uint64_t patientId, int triage, double simMinute);
+//   std::optional<std::uint64_t> dequeue(int doctor, double simMinute);
+//   bool cancel(std::uint64_t patientId, double simMinute);
+// Внутри — PatientQueue, Doctor, DataBaseWorker или их заглушки.
+//
+// Если у Driver есть
+//   std::vector<std::pair<int, std::uint64_t>> assign(const std::vector<int>& idleDoctors, double simMinute);
+// свободные врачи назначаются одной пачкой (например, через AssignmentEngine),
+// а dequeue не нужен; замеры такого вызова идут в Report::dequeue.
+//
+// Если у Driver есть
+//   double service_minutes(int doctor, std::uint64_t patientId, double baseMinutes);
+// длительность приёма зависит от пары врач–пациент (например, узкий
+// специалист быстрее принимает своих); без него — baseMinutes из трассы.
+class LoadSimulator {
+public:
+    struct Arrival {
+        double        minute = 0.0;
+        std::uint64_t patientId = 0;
+        int           triage = 3;
+        double        serviceMinutes = 10.0;
+        double        cancelAfterMinutes = -1.0; // < 0 — не отменяет
+    };
+
+    // По умолчанию нагрузка ρ = 0.7 * 12 / 10 = 0.84: очередь устойчива, но
+    // врачи заняты плотно. При ρ >= 1 очередь растёт без предела, и перцентили
+    // ожидания зависят только от длительности прогона.
+    struct Config {
+        double              arrivalsPerMinute  = 0.7;
+        int                 doctors            = 10;
+        double              meanServiceMinutes = 12.0;
+        // При ρ = 0.84 ожидание обычно в пределах 20 минут, так что отмены
+        // случаются, только если терпение короче: по умолчанию несколько
+        // отмен за смену. cancelProbability = 0 выключает их совсем.
+        double              cancelProbability  = 0.3;
+        double              meanPatienceMinutes = 15.0; // через сколько в среднем уходит отменяющий
+        double              durationMinutes    = 8 * 60.0;
+        std::vector<double> triageWeights      = {0.05, 0.15, 0.4, 0.3, 0.1}; // уровни 1..5
+        std::uint64_t       seed               = 42;
+        // Текущее число аллокаций (например, allocation_count из AllocationCounter.h);
+        // если задан, отчёт считает аллокации внутри вызовов Driver
+        std::function<std::uint64_t()> allocationCounter;
+
+        // Загрузка врачей ρ = λ / (c·μ)
+        double utilization() const { return arrivalsPerMinute * meanServiceMinutes / doctors; }
+    };
+
+    struct Report {
+        std::size_t     arrivals = 0;
+        std::size_t     served   = 0;
+        std::size_t     cancelled = 0;
+        double          wallSeconds = 0.0;
+        LatencyRecorder enqueue;
+        LatencyRecorder dequeue;
+        LatencyRecorder cancel;
+        LatencyRecorder waitSeconds; // модельное ожидание пациента до вызова к врачу
+        bool            allocationsCounted = false;
+        std::uint64_t   allocations = 0;
+
+        double ops_per_second() const
+        {
+            const double ops = static_cast<double>(enqueue.count() + dequeue.count() + cancel.count());
+            return wallSeconds > 0 ? ops / wallSeconds : 0.0;
+        }
+
+        void print(std::ostream& os)
+        {
+            auto line = [&os](const char* name, LatencyRecorder& r) {
+                os << name << ": n=" << r.count() << " p50=" << r.percentile(0.5) << "ns p99="
+                   << r.percentile(0.99) << "ns p999=" << r.percentile(0.999) << "ns\n";
+            };
+            os << "arrivals=" << arrivals << " served=" << served << " cancelled=" << cancelled
+               << " wall=" << wallSeconds << "s throughput=" << ops_per_second() << " ops/s\n";
+            line("enqueue", enqueue);
+            line("dequeue", dequeue);
+            line("cancel ", cancel);
+            if (allocationsCounted) {
+                const std::size_t ops = enqueue.count() + dequeue.count() + cancel.count();
+                os << "allocations: " << allocations << " ("
+                   << (ops ? static_cast<double>(allocations) / static_cast<double>(ops) : 0.0) << " per op)\n";
+            }
+            os << "wait: mean=" << waitSeconds.mean() / 60 << "min p50="
+               << static_cast<double>(waitSeconds.percentile(0.5)) / 60.0
+               << "min p99=" << static_cast<double>(waitSeconds.percentile(0.99)) / 60.0 << "min\n";
+        }
+    };
+
+    explicit LoadSimulator(Config config) : config_(std::move(config))
+    {
+        if (config_.doctors <= 0 || config_.arrivalsPerMinute <= 0 || config_.triageWeights.empty())
+            throw std::invalid_argument("LoadSimulator: invalid config");
+    }
+
+    // Пуассоновский поток приходов по конфигурации
+    std::vector<Arrival> generate() const
+    {
+        std::mt19937_64 rng(config_.seed);
+        std::exponential_distribution<double> gap(config_.arrivalsPerMinute);
+        std::exponential_distribution<double> service(1.0 / config_.meanServiceMinutes);
+        std::exponential_distribution<double> patience(1.0 / config_.meanPatienceMinutes);
+        std::bernoulli_distribution willCancel(config_.cancelProbability);
+        std::discrete_distribution<int> triage(config_.triageWeights.begin(), config_.triageWeights.end());
+
+        std::vector<Arrival> out;
+        double t = 0.0;
+        for (std::uint64_t id = 1;; ++id) {
+            t += gap(rng);
+            if (t >= config_.durationMinutes)
+                break;
+            Arrival a;
+            a.minute = t;
+            a.patientId = id;
+            a.triage = triage(rng) + 1;
+            a.serviceMinutes = service(rng);
+            a.cancelAfterMinutes = willCancel(rng) ? patience(rng) : -1.0;
+            out.push_back(a);
+        }
+        return out;
+    }
+
+    template <typename Driver>
+    Report run(Driver& driver) const
+    {
+        return run(driver, generate());
+    }
+
+    // Прогон по готовой трассе (например, выгрузке реального дня)
+    template <typename Driver>
+    Report run(Driver& driver, const std::vector<Arrival>& trace) const
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Report report;
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+        std::unordered_set<std::uint64_t> waiting;
+        std::vector<int> idleDoctors;
+        for (int d = config_.doctors - 1; d >= 0; --d)
+            idleDoctors.push_back(d);
+
+        for (std::size_t i = 0; i < trace.size(); ++i) {
+            events.push(Event{trace[i].minute, Event::Arrive, i, 0});
+            if (trace[i].cancelAfterMinutes >= 0)
+                events.push(Event{trace[i].minute + trace[i].cancelAfterMinutes, Event::Cancel, i, 0});
+        }
+
+        // Память под замеры — заранее, чтобы рост векторов не мешал ни
+        // задержкам, ни счётчику аллокаций. dequeue вызывается на каждого
+        // вызванного пациента плюс не больше одного пустого раза на событие
+        // (приход, отмена, конец приёма).
+        std::size_t cancels = 0;
+        for (const Arrival& a : trace)
+            cancels += a.cancelAfterMinutes >= 0 ? 1 : 0;
+        report.enqueue.reserve(trace.size());
+        report.cancel.reserve(cancels);
+        report.dequeue.reserve(3 * trace.size() + cancels);
+        report.waitSeconds.reserve(trace.size());
+
+        report.allocationsCounted = static_cast<bool>(config_.allocationCounter);
+        auto timed = [&](LatencyRecorder& r, auto&& fn) {
+            const std::uint64_t allocsBefore = report.allocationsCounted ? config_.allocationCounter() : 0;
+            const auto start = Clock::now();
+            auto result = fn();
+            const auto elapsed = Clock::now() - start;
+            // Счётчик — сразу после вызова Driver, до record()
+            if (report.allocationsCounted)
+                report.allocations += config_.allocationCounter() - allocsBefore;
+            r.record(elapsed);
+            return result;
+        };
+
+        std::unordered_map<std::uint64_t, std::size_t> indexOf; // patientId -> индекс в трассе
+        indexOf.reserve(trace.size());
+        for (std::size_t i = 0; i < trace.size(); ++i)
+            indexOf[trace[i].patientId] = i;
+        auto traceIndex = [&](std::uint64_t id) -> std::optional<std::size_t> {
+            auto it = indexOf.find(id);
+            if (it == indexOf.end())
+                return std::nullopt;
+            return it->second;
+        };
+
+        // false — Driver отдал пациента, которого нет в очереди
+        auto startVisit = [&](int doctor, std::uint64_t patientId, double now) {
+            const auto idx = traceIndex(patientId);
+            if (!idx || !waiting.erase(patientId))
+                return false;
+            ++report.served;
+            report.waitSeconds.record(static_cast<std::int64_t>((now - trace[*idx].minute) * 60.0));
+            double minutes = trace[*idx].serviceMinutes;
+            if constexpr (HasServiceMinutes<Driver>::value)
+                minutes = driver.service_minutes(doctor, patientId, minutes);
+            events.push(Event{now + minutes, Event::Done, *idx, doctor});
+            return true;
+        };
+
+        // Свободные врачи забирают пациентов, пока очередь не опустеет
+        auto dispatch = [&](double now) {
+            if constexpr (HasBatchAssign<Driver>::value) {
+                if (idleDoctors.empty() || waiting.empty())
+                    return;
+                const auto pairs = timed(report.dequeue, [&] { return driver.assign(idleDoctors, now); });
+                for (const auto& [doctor, patientId] : pairs) {
+                    auto it = std::find(idleDoctors.begin(), idleDoctors.end(), doctor);
+                    if (it != idleDoctors.end() && startVisit(doctor, patientId, now))
+                        idleDoctors.erase(it);
+                }
+            } else {
+                while (!idleDoctors.empty()) {
+                    const int doctor = idleDoctors.back();
+                    const std::optional<std::uint64_t> next =
+                        timed(report.dequeue, [&] { return driver.dequeue(doctor, now); });
+                    if (!next)
+                        return;
+                    if (startVisit(doctor, *next, now))
+                        idleDoctors.pop_back();
+                }
+            }
+        };
+
+        const auto wallStart = Clock::now();
+        while (!events.empty()) {
+            const Event e = events.top();
+            events.pop();
+            const Arrival& a = trace[e.index];
+
+            switch (e.kind) {
+            case Event::Arrive:
+                ++report.arrivals;
+                waiting.insert(a.patientId);
+                timed(report.enqueue, [&] {
+                    driver.enqueue(a.patientId, a.triage, e.minute);
+                    return 0;
+                });
+                break;
+            case Event::Cancel:
+                if (waiting.count(a.patientId)) {
+                    const bool removed = timed(report.cancel, [&] { return driver.cancel(a.patientId, e.minute); });
+                    if (removed) {
+                        waiting.erase(a.patientId);
+                        ++report.cancelled;
+                    }
+                }
+                break;
+            case Event::Done:
+                idleDoctors.push_back(e.doctor);
+                break;
+            }
+            dispatch(e.minute);
+        }
+        report.wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+        return report;
+    }
+
+private:
+    template <typename Driver, typename = void>
+    struct HasBatchAssign : std::false_type {};
+
+    template <typename Driver>
+    struct HasBatchAssign<Driver, std::void_t<decltype(std::declval<Driver&>().assign(
+                                      std::declval<const std::vector<int>&>(), 0.0))>> : std::true_type {};
+
+    template <typename Driver, typename = void>
+    struct HasServiceMinutes : std::false_type {};
+
+    template <typename Driver>
+    struct HasServiceMinutes<Driver, std::void_t<decltype(std::declval<Driver&>().service_minutes(
+                                         0, std::uint64_t{}, 0.0))>> : std::true_type {};
+
+    struct Event {
+        enum Kind { Done = 0, Cancel = 1, Arrive = 2 }; // при равном времени врач освобождается раньше
+        double      minute;
+        Kind        kind;
+        std::size_t index;
+        int         doctor;
+
+        bool operator>(const Event& o) const
+        {
+            return minute != o.minute ? minute > o.minute : kind > o.kind;
+        }
+    };
+
+    Config config_;
+};
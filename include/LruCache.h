@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Read-through LRU-кэш перед запросами DataBaseWorker (например, Patient по id).
+// Ключи раскиданы по шардам, у каждого шарда свой мьютекс и свой LRU-список.
+// Отсутствующие в БД ключи тоже кэшируются (negative caching) с отдельным TTL,
+// чтобы повторные запросы несуществующих id не доходили до Postgres.
+// invalidate/clear сдвигают эпоху шарда: загрузка, начатая до инвалидации,
+// не попадёт в кэш, поэтому устаревшая строка из БД не переживёт NOTIFY.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    using KeyType   = Key;
+    using ValueType = Value;
+    using Clock     = std::chrono::steady_clock;
+
+    struct Options {
+        std::size_t     capacity    = 100000; // суммарно по всем шардам
+        std::size_t     shards      = 16;
+        Clock::duration ttl         = std::chrono::minutes(5);
+        Clock::duration negativeTtl = std::chrono::seconds(30);
+    };
+
+    struct Stats {
+        std::uint64_t hits          = 0;
+        std::uint64_t negativeHits  = 0;
+        std::uint64_t misses        = 0;
+        std::uint64_t loads         = 0;
+        std::uint64_t evictions     = 0;
+        std::uint64_t expirations   = 0;
+        std::uint64_t invalidations = 0;
+    };
+
+    explicit LruCache(Options options = Options())
+        : options_(options), shards_(options.shards == 0 ? 1 : options.shards)
+    {
+        if (options_.capacity == 0)
+            throw std::invalid_argument("LruCache: capacity must be > 0");
+        perShard_ = (options_.capacity + shards_.size() - 1) / shards_.size();
+    }
+
+    // Значение из кэша; nullopt — промах (или закэшированное отсутствие)
+    std::optional<Value> get(const Key& key)
+    {
+        bool found = false;
+        std::uint64_t epoch = 0;
+        auto value = lookup(key, found, epoch);
+        if (!found)
+            counters_.misses.fetch_add(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    // Значение из кэша, при промахе — из loader (вызывается без блокировки шарда).
+    // loader возвращает std::optional<Value>; nullopt кэшируется как отсутствие.
+    template <typename Loader>
+    std::optional<Value> get_or_load(const Key& key, Loader&& loader)
+    {
+        bool found = false;
+        std::uint64_t epoch = 0;
+        auto value = lookup(key, found, epoch);
+        if (found)
+            return value;
+
+        counters_.misses.fetch_add(1, std::memory_order_relaxed);
+        counters_.loads.fetch_add(1, std::memory_order_relaxed);
+        std::optional<Value> loaded = loader(key);
+        store(key, loaded, &epoch);
+        return loaded;
+    }
+
+    void put(const Key& key, Value value) { store(key, std::optional<Value>(std::move(value)), nullptr); }
+
+    // Пометить id как отсутствующий в БД
+    void put_missing(const Key& key) { store(key, std::nullopt, nullptr); }
+
+    bool invalidate(const Key& key)
+    {
+        Shard& s = shardFor(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        ++s.epoch;
+        auto it = s.index.find(key);
+        if (it == s.index.end())
+            return false;
+        s.lru.erase(it->second);
+        s.index.erase(it);
+        counters_.invalidations.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void clear()
+    {
+        for (Shard& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            ++s.epoch;
+            s.lru.clear();
+            s.index.clear();
+        }
+    }
+
+    std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (const Shard& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            total += s.index.size();
+        }
+        return total;
+    }
+
+    Stats stats() const
+    {
+        Stats out;
+        out.hits          = counters_.hits.load(std::memory_order_relaxed);
+        out.negativeHits  = counters_.negativeHits.load(std::memory_order_relaxed);
+        out.misses        = counters_.misses.load(std::memory_order_relaxed);
+        out.loads         = counters_.loads.load(std::memory_order_relaxed);
+        out.evictions     = counters_.evictions.load(std::memory_order_relaxed);
+        out.expirations   = counters_.expirations.load(std::memory_order_relaxed);
+        out.invalidations = counters_.invalidations.load(std::memory_order_relaxed);
+        return out;
+    }
+
+private:
+    struct Entry {
+        Key                  key;
+        std::optional<Value> value; // nullopt — "нет в БД"
+        Clock::time_point    expires;
+    };
+
+    using List = std::list<Entry>;
+
+    struct alignas(64) Shard {
+        mutable std::mutex                                        mutex;
+        List                                                      lru; // голова — самый свежий
+        std::unordered_map<Key, typename List::iterator, Hash>    index;
+        std::uint64_t                                             epoch = 0;
+    };
+
+    struct Counters {
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> negativeHits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> loads{0};
+        std::atomic<std::uint64_t> evictions{0};
+        std::atomic<std::uint64_t> expirations{0};
+        std::atomic<std::uint64_t> invalidations{0};
+    };
+
+    Shard& shardFor(const Key& key)
+    {
+        // Старшие биты хеша, чтобы шард не совпадал с бакетом внутри unordered_map
+        const std::size_t h = Hash()(key);
+        return shards_[(h ^ (h >> 17)) % shards_.size()];
+    }
+
+    std::optional<Value> lookup(const Key& key, bool& found, std::uint64_t& epoch)
+    {
+        Shard& s = shardFor(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        epoch = s.epoch;
+        auto it = s.index.find(key);
+        if (it == s.index.end())
+            return std::nullopt;
+
+        auto node = it->second;
+        if (node->expires <= Clock::now()) {
+            s.lru.erase(node);
+            s.index.erase(it);
+            counters_.expirations.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        s.lru.splice(s.lru.begin(), s.lru, node);
+        found = true;
+        if (node->value)
+            counters_.hits.fetch_add(1, std::memory_order_relaxed);
+        else
+            counters_.negativeHits.fetch_add(1, std::memory_order_relaxed);
+        return node->value;
+    }
+
+    // loadEpoch != nullptr — значение пришло из loader и кладётся, только
+    // если шард не инвалидировали, пока шла загрузка
+    void store(const Key& key, std::optional<Value> value, const std::uint64_t* loadEpoch)
+    {
+        const auto expires = Clock::now() + (value ? options_.ttl : options_.negativeTtl);
+
+        Shard& s = shardFor(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (loadEpoch && *loadEpoch != s.epoch)
+            return;
+        auto it = s.index.find(key);
+        if (it != s.index.end()) {
+            it->second->value   = std::move(value);
+            it->second->expires = expires;
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            return;
+        }
+
+        s.lru.push_front(Entry{key, std::move(value), expires});
+        s.index.emplace(key, s.lru.begin());
+        while (s.index.size() > perShard_) {
+            s.index.erase(s.lru.back().key);
+            s.lru.pop_back();
+            counters_.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    Options            options_;
+    std::vector<Shard> shards_;
+    std::size_t        perShard_ = 0;
+    Counters           counters_;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Lock-free ограниченная MPMC-очередь (схема Вьюкова) для простых FIFO-отделений
+// без триажа. Каждый слот хранит номер последовательности: производитель
+// пишет в слот, когда seq == pos, потребитель читает, когда seq == pos + 1.
+// Слоты и счётчики выровнены по кэш-линии, чтобы потоки не делили линии.
+//
+// Слот, захваченный CAS-ом, обязан быть заполнен и освобождён без
+// исключений — иначе seq не продвинется и очередь встанет навсегда.
+// Поэтому перемещение T должно быть noexcept, а бросающий конструктор
+// отрабатывает до захвата слота.
+template <typename T>
+class MpmcRingBuffer {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "MpmcRingBuffer: T must be nothrow move constructible");
+
+public:
+    static constexpr std::size_t kCacheLine = 64;
+
+    // Ёмкость округляется вверх до степени двойки
+    explicit MpmcRingBuffer(std::size_t capacity)
+    {
+        if (capacity < 2)
+            capacity = 2;
+        std::size_t pow2 = 1;
+        while (pow2 < capacity)
+            pow2 <<= 1;
+        mask_ = pow2 - 1;
+
+        slots_ = static_cast<Slot*>(::operator new(sizeof(Slot) * pow2, std::align_val_t(alignof(Slot))));
+        for (std::size_t i = 0; i < pow2; ++i)
+            new (&slots_[i]) Slot(i);
+    }
+
+    MpmcRingBuffer(const MpmcRingBuffer&)            = delete;
+    MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+    ~MpmcRingBuffer()
+    {
+        while (try_pop()) {
+        }
+        for (std::size_t i = 0; i <= mask_; ++i)
+            slots_[i].~Slot();
+        ::operator delete(slots_, std::align_val_t(alignof(Slot)));
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // false — очередь заполнена
+    template <typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+            return claim([&](void* p) { new (p) T(std::forward<Args>(args)...); });
+        } else {
+            // Исключение вылетит здесь, пока слот ещё не захвачен
+            T value(std::forward<Args>(args)...);
+            return claim([&](void* p) { new (p) T(std::move(value)); });
+        }
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    // nullopt — очередь пуста
+    std::optional<T> try_pop()
+    {
+        std::size_t pos = head_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* item = slot.storage();
+                    std::optional<T> result(std::move(*item));
+                    item->~T();
+                    slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return result;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = head_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Приблизительный размер: под нагрузкой может устареть сразу после чтения
+    std::size_t size_approx() const
+    {
+        const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+        const std::size_t head = head_.value.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+private:
+    // construct(void*) вызывается на уже захваченном слоте и не бросает
+    template <typename Construct>
+    bool claim(Construct&& construct)
+    {
+        std::size_t pos = tail_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    construct(&slot.data);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    struct alignas(kCacheLine) Slot {
+        explicit Slot(std::size_t s) : seq(s) {}
+
+        T* storage() { return std::launder(reinterpret_cast<T*>(&data)); }
+
+        std::atomic<std::size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data;
+    };
+
+    struct alignas(kCacheLine) Counter {
+        std::atomic<std::size_t> value{0};
+    };
+
+    Slot*       slots_ = nullptr;
+    std::size_t mask_  = 0;
+    Counter     head_;
+    Counter     tail_;
+};
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Упорядоченное множество с размерами поддеревьев (декартово дерево):
+// вставка, удаление, rank (сколько ключей меньше), select (k-й ключ) и
+// подсчёт в диапазоне — за O(log n) в среднем.
+//
+// Узлы лежат в одном векторе и связаны индексами, освобождённые идут в
+// список свободных — после разогрева вставка и удаление не аллоцируют.
+template <typename Key, typename Compare = std::less<Key>>
+class OrderStatisticTree {
+public:
+    explicit OrderStatisticTree(Compare less = Compare()) : less_(std::move(less)), nodes_(1) {}
+
+    std::size_t size() const { return nodes_[root_].size; }
+    bool        empty() const { return root_ == kNil; }
+
+    // false — ключ уже есть
+    bool insert(const Key& key)
+    {
+        if (contains(key))
+            return false;
+        auto [lo, hi] = split(root_, key);
+        root_ = merge(merge(lo, allocate(key)), hi);
+        return true;
+    }
+
+    bool erase(const Key& key)
+    {
+        bool erased = false;
+        root_ = eraseAt(root_, key, erased);
+        return erased;
+    }
+
+    bool contains(const Key& key) const
+    {
+        std::uint32_t t = root_;
+        while (t != kNil) {
+            if (less_(key, nodes_[t].key))
+                t = nodes_[t].left;
+            else if (less_(nodes_[t].key, key))
+                t = nodes_[t].right;
+            else
+                return true;
+        }
+        return false;
+    }
+
+    // Число ключей строго меньше key
+    std::size_t rank(const Key& key) const
+    {
+        std::size_t r = 0;
+        std::uint32_t t = root_;
+        while (t != kNil) {
+            if (less_(nodes_[t].key, key)) {
+                r += nodes_[nodes_[t].left].size + 1;
+                t = nodes_[t].right;
+            } else {
+                t = nodes_[t].left;
+            }
+        }
+        return r;
+    }
+
+    // k-й по порядку ключ, k с нуля
+    const Key& select(std::size_t k) const
+    {
+        if (k >= size())
+            throw std::out_of_range("OrderStatisticTree: select() past the end");
+        std::uint32_t t = root_;
+        for (;;) {
+            const std::size_t leftSize = nodes_[nodes_[t].left].size;
+            if (k < leftSize) {
+                t = nodes_[t].left;
+            } else if (k == leftSize) {
+                return nodes_[t].key;
+            } else {
+                k -= leftSize + 1;
+                t = nodes_[t].right;
+            }
+        }
+    }
+
+    // Число ключей в [lo, hi)
+    std::size_t count_range(const Key& lo, const Key& hi) const
+    {
+        if (!less_(lo, hi))
+            return 0;
+        return rank(hi) - rank(lo);
+    }
+
+    const Key& front() const { return select(0); }
+
+    void pop_front()
+    {
+        if (empty())
+            throw std::out_of_range("OrderStatisticTree: pop_front() on empty tree");
+        erase(Key(front()));
+    }
+
+    void clear()
+    {
+        nodes_.resize(1);
+        free_.clear();
+        root_ = kNil;
+    }
+
+    // Обход по возрастанию; fn(const Key&)
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        std::vector<std::uint32_t> stack;
+        std::uint32_t t = root_;
+        while (t != kNil || !stack.empty()) {
+            while (t != kNil) {
+                stack.push_back(t);
+                t = nodes_[t].left;
+            }
+            t = stack.back();
+            stack.pop_back();
+            fn(nodes_[t].key);
+            t = nodes_[t].right;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t kNil = 0; // nodes_[0] — пустой узел с size 0
+
+    struct Node {
+        Key           key{};
+        std::uint32_t left = kNil;
+        std::uint32_t right = kNil;
+        std::uint32_t size = 0;
+        std::uint32_t priority = 0;
+    };
+
+    std::uint32_t allocate(const Key& key)
+    {
+        std::uint32_t i;
+        if (!free_.empty()) {
+            i = free_.back();
+            free_.pop_back();
+        } else {
+            i = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node& n = nodes_[i];
+        n.key = key;
+        n.left = n.right = kNil;
+        n.size = 1;
+        n.priority = nextPriority();
+        return i;
+    }
+
+    // xorshift32: приоритеты узлов должны быть случайными, качество не важно
+    std::uint32_t nextPriority()
+    {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        return seed_;
+    }
+
+    void update(std::uint32_t t) { nodes_[t].size = nodes_[nodes_[t].left].size + nodes_[nodes_[t].right].size + 1; }
+
+    // (ключи < key, ключи >= key)
+    std::pair<std::uint32_t, std::uint32_t> split(std::uint32_t t, const Key& key)
+    {
+        if (t == kNil)
+            return {kNil, kNil};
+        if (less_(nodes_[t].key, key)) {
+            auto [lo, hi] = split(nodes_[t].right, key);
+            nodes_[t].right = lo;
+            update(t);
+            return {t, hi};
+        }
+        auto [lo, hi] = split(nodes_[t].left, key);
+        nodes_[t].left = hi;
+        update(t);
+        return {lo, t};
+    }
+
+    // Все ключи a меньше всех ключей b
+    std::uint32_t merge(std::uint32_t a, std::uint32_t b)
+    {
+        if (a == kNil)
+            return b;
+        if (b == kNil)
+            return a;
+        if (nodes_[a].priority > nodes_[b].priority) {
+            nodes_[a].right = merge(nodes_[a].right, b);
+            update(a);
+            return a;
+        }
+        nodes_[b].left = merge(a, nodes_[b].left);
+        update(b);
+        return b;
+    }
+
+    std::uint32_t eraseAt(std::uint32_t t, const Key& key, bool& erased)
+    {
+        if (t == kNil)
+            return kNil;
+        if (less_(key, nodes_[t].key)) {
+            nodes_[t].left = eraseAt(nodes_[t].left, key, erased);
+        } else if (less_(nodes_[t].key, key)) {
+            nodes_[t].right = eraseAt(nodes_[t].right, key, erased);
+        } else {
+            erased = true;
+            const std::uint32_t rest = merge(nodes_[t].left, nodes_[t].right);
+            nodes_[t].key = Key{};
+            free_.push_back(t);
+            return rest;
+        }
+        update(t);
+        return t;
+    }
+
+    Compare                    less_;
+    std::vector<Node>          nodes_;
+    std::vector<std::uint32_t> free_;
+    std::uint32_t              root_ = kNil;
+    std::uint32_t              seed_ = 2463534242u;
+};
+
+// Индекс «моё место в очереди»: пациенты упорядочены по (приоритет, номер
+// прихода), где меньший приоритет обслуживается раньше — тот же порядок,
+// в котором их отдают IndexedDaryHeap и ShardedQueue с Compare по умолчанию.
+// Держится рядом с PatientQueue и обновляется на тех же событиях.
+class QueuePositionIndex {
+public:
+    struct Entry {
+        int           priority = 0;
+        std::uint64_t arrival = 0;
+        std::uint64_t patientId = 0;
+
+        bool operator<(const Entry& o) const
+        {
+            return std::tie(priority, arrival, patientId) < std::tie(o.priority, o.arrival, o.patientId);
+        }
+    };
+
+    // arrival — монотонный номер или время прихода; false — пациент уже в индексе
+    bool add(std::uint64_t patientId, int priority, std::uint64_t arrival)
+    {
+        const Entry e{priority, arrival, patientId};
+        if (!entries_.emplace(patientId, e).second)
+            return false;
+        tree_.insert(e);
+        return true;
+    }
+
+    bool remove(std::uint64_t patientId)
+    {
+        auto it = entries_.find(patientId);
+        if (it == entries_.end())
+            return false;
+        tree_.erase(it->second);
+        entries_.erase(it);
+        return true;
+    }
+
+    bool change_priority(std::uint64_t patientId, int priority)
+    {
+        auto it = entries_.find(patientId);
+        if (it == entries_.end())
+            return false;
+        tree_.erase(it->second);
+        it->second.priority = priority;
+        tree_.insert(it->second);
+        return true;
+    }
+
+    // 0 — следующий
+    std::optional<std::size_t> position(std::uint64_t patientId) const
+    {
+        auto it = entries_.find(patientId);
+        if (it == entries_.end())
+            return std::nullopt;
+        return tree_.rank(it->second);
+    }
+
+    // Пациент на месте k
+    std::uint64_t at(std::size_t k) const { return tree_.select(k).patientId; }
+
+    // Сколько ждут с приоритетом в [lo, hi]
+    std::size_t count_priority(int lo, int hi) const
+    {
+        if (lo > hi)
+            return 0;
+        const std::size_t upper = hi == INT_MAX ? tree_.size() : tree_.rank(Entry{hi + 1, 0, 0});
+        return upper - tree_.rank(Entry{lo, 0, 0});
+    }
+
+    std::size_t size() const { return tree_.size(); }
+
+private:
+    OrderStatisticTree<Entry>                   tree_;
+    std::unordered_map<std::uint64_t, Entry>    entries_;
+};
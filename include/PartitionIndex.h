@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Клиентский индекс границ партиций таблицы визитов (RANGE по времени).
+// Знает, какие партиции уже есть, выдаёт DDL для недостающих и по
+// диапазону времени отбирает только нужные партиции, чтобы запрос истории
+// шёл прямо в них, а не в родительскую таблицу целиком.
+//
+// Партиции называются `<parent>_YYYYMMDD` (по UTC началу партиции, в схеме родителя),
+// ширина задаётся в секундах и должна быть кратна суткам. Имена и границы
+// при ширине в сутки совпадают с create_visit_partition() из sql/visit_partitions.sql.
+class PartitionIndex {
+public:
+    struct Partition {
+        std::int64_t from = 0; // включительно, секунды Unix
+        std::int64_t to   = 0; // не включительно
+        std::string  name;
+    };
+
+    explicit PartitionIndex(std::string parent, std::int64_t widthSec = 86400)
+        : parent_(std::move(parent)), width_(widthSec)
+    {
+        if (width_ <= 0 || width_ % 86400 != 0)
+            throw std::invalid_argument("PartitionIndex: width must be a whole number of days");
+    }
+
+    const std::string& parent() const { return parent_; }
+    std::int64_t       width() const { return width_; }
+
+    std::int64_t partition_start(std::int64_t ts) const
+    {
+        std::int64_t r = ts % width_;
+        if (r < 0)
+            r += width_;
+        return ts - r;
+    }
+
+    std::string name_for(std::int64_t ts) const
+    {
+        return parent_ + "_" + formatUtc(partition_start(ts), "%Y%m%d");
+    }
+
+    // Запомнить существующую партицию (например, при старте из pg_inherits)
+    void add(std::int64_t ts)
+    {
+        const std::int64_t start = partition_start(ts);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        partitions_.emplace(start, Partition{start, start + width_, name_for(start)});
+    }
+
+    bool contains(std::int64_t ts) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return partitions_.count(partition_start(ts)) != 0;
+    }
+
+    // DDL для партиции, в которую попадает ts; идемпотентен (IF NOT EXISTS)
+    std::string create_sql(std::int64_t ts) const
+    {
+        const std::int64_t start = partition_start(ts);
+        return "CREATE TABLE IF NOT EXISTS " + name_for(start) + " PARTITION OF " + parent_ +
+               " FOR VALUES FROM ('" + formatUtc(start, "%Y-%m-%d %H:%M:%S+00") + "') TO ('" +
+               formatUtc(start + width_, "%Y-%m-%d %H:%M:%S+00") + "')";
+    }
+
+    // Имя партиции из pg_inherits (relname без схемы); false — имя не наше
+    bool add_name(const std::string& relname)
+    {
+        const std::string prefix = relName(parent_) + "_";
+        if (relname.size() != prefix.size() + 8 || relname.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        std::tm tm{};
+        for (std::size_t i = prefix.size(); i < relname.size(); ++i)
+            if (relname[i] < '0' || relname[i] > '9')
+                return false;
+        tm.tm_year = std::stoi(relname.substr(prefix.size(), 4)) - 1900;
+        tm.tm_mon = std::stoi(relname.substr(prefix.size() + 4, 2)) - 1;
+        tm.tm_mday = std::stoi(relname.substr(prefix.size() + 6, 2));
+        add(static_cast<std::int64_t>(timegm(&tm)));
+        return true;
+    }
+
+    // Запрос списка партиций на сервере — результат скармливается add_name().
+    // Партиции создаёт и ensure_visit_partitions() в обход индекса, поэтому
+    // индекс стоит обновлять перед выборкой истории (или хотя бы периодически).
+    // Имя родителя идёт строковым литералом, кавычки в нём удваиваются.
+    std::string list_sql() const
+    {
+        return "SELECT c.relname FROM pg_inherits i JOIN pg_class c ON c.oid = i.inhrelid"
+               " WHERE i.inhparent = " + quoteLiteral(parent_) + "::regclass";
+    }
+
+    // Известные партиции, пересекающиеся с [from, to), по возрастанию времени
+    std::vector<Partition> prune(std::int64_t from, std::int64_t to) const
+    {
+        std::vector<Partition> out;
+        if (to <= from)
+            return out;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (auto it = partitions_.lower_bound(partition_start(from));
+             it != partitions_.end() && it->first < to; ++it)
+            out.push_back(it->second);
+        return out;
+    }
+
+    // Весь [from, to) покрыт известными партициями без дыр
+    bool covers(std::int64_t from, std::int64_t to) const
+    {
+        if (to <= from)
+            return false;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (std::int64_t start = partition_start(from); start < to; start += width_)
+            if (!partitions_.count(start))
+                return false;
+        return true;
+    }
+
+    // FROM-часть запроса истории: одна партиция — она сама, несколько —
+    // UNION ALL только по ним. Если индекс знает диапазон не целиком (партицию
+    // создали в обход него), запрос идёт в родительскую таблицу — Postgres
+    // отсечёт лишние партиции по WHERE сам, а строки не потеряются.
+    // Условие по времени в WHERE нужно в любом случае: крайние партиции
+    // покрывают диапазон не целиком.
+    std::string from_clause(std::int64_t from, std::int64_t to, const std::string& alias = "v") const
+    {
+        if (!covers(from, to))
+            return parent_ + " AS " + alias;
+        const std::vector<Partition> parts = prune(from, to);
+        if (parts.size() == 1)
+            return parts.front().name + " AS " + alias;
+
+        std::string sql = "(";
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            if (i != 0)
+                sql += " UNION ALL ";
+            sql += "SELECT * FROM " + parts[i].name;
+        }
+        return sql + ") AS " + alias;
+    }
+
+private:
+    // "schema.visits" -> "visits"
+    static std::string relName(const std::string& qualified)
+    {
+        const auto dot = qualified.rfind('.');
+        return dot == std::string::npos ? qualified : qualified.substr(dot + 1);
+    }
+
+    // 'it''s' — литерал SQL (standard_conforming_strings, обратная косая не особая)
+    static std::string quoteLiteral(const std::string& s)
+    {
+        std::string out = "'";
+        for (const char c : s) {
+            if (c == '\'')
+                out += '\'';
+            out += c;
+        }
+        return out + "'";
+    }
+
+    static std::string formatUtc(std::int64_t ts, const char* format)
+    {
+        const std::time_t t = static_cast<std::time_t>(ts);
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        char buf[32];
+        const std::size_t n = std::strftime(buf, sizeof(buf), format, &tm);
+        return std::string(buf, n);
+    }
+
+    std::string                           parent_;
+    std::int64_t                          width_;
+    mutable std::shared_mutex             mutex_;
+    std::map<std::int64_t, Partition>     partitions_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "Storage.h"
+
+// Storage поверх Postgres: синхронные PQexecParams на одном соединении,
+// которым владеет вызывающий. Параметры — текстом, все запросы с
+// плейсхолдерами. Схема (имена — под свою):
+//
+//   patients(id bigint PK, full_name text, triage int, department text, arrived_at bigint)
+//   doctors (id int PK, full_name text, specialty text, on_shift boolean)
+//   visits  (id bigserial PK, patient_id bigint, doctor_id int, visit_time bigint,
+//            duration_sec int, status smallint)
+//
+// Соединение не потокобезопасно — один PgStorage на поток.
+class PgStorage final : public Storage {
+public:
+    explicit PgStorage(PGconn* conn) : conn_(conn) {}
+
+    void upsert_patient(const PatientRow& r) override
+    {
+        exec("INSERT INTO patients (id, full_name, triage, department, arrived_at) VALUES ($1, $2, $3, $4, $5) "
+             "ON CONFLICT (id) DO UPDATE SET full_name = EXCLUDED.full_name, triage = EXCLUDED.triage, "
+             "department = EXCLUDED.department, arrived_at = EXCLUDED.arrived_at",
+             {std::to_string(r.id), r.fullName, std::to_string(r.triage), r.department, std::to_string(r.arrivedAt)});
+    }
+
+    std::optional<PatientRow> find_patient(std::int64_t id) override
+    {
+        Result res = exec("SELECT id, full_name, triage, department, arrived_at FROM patients WHERE id = $1",
+                          {std::to_string(id)});
+        if (PQntuples(res.get()) == 0)
+            return std::nullopt;
+        PatientRow r;
+        r.id = toInt(res, 0, 0);
+        r.fullName = PQgetvalue(res.get(), 0, 1);
+        r.triage = static_cast<int>(toInt(res, 0, 2));
+        r.department = PQgetvalue(res.get(), 0, 3);
+        r.arrivedAt = toInt(res, 0, 4);
+        return r;
+    }
+
+    bool erase_patient(std::int64_t id) override
+    {
+        return affected(exec("DELETE FROM patients WHERE id = $1", {std::to_string(id)}));
+    }
+
+    void upsert_doctor(const DoctorRow& r) override
+    {
+        exec("INSERT INTO doctors (id, full_name, specialty, on_shift) VALUES ($1, $2, $3, $4) "
+             "ON CONFLICT (id) DO UPDATE SET full_name = EXCLUDED.full_name, specialty = EXCLUDED.specialty, "
+             "on_shift = EXCLUDED.on_shift",
+             {std::to_string(r.id), r.fullName, r.specialty, r.onShift ? "true" : "false"});
+    }
+
+    std::optional<DoctorRow> find_doctor(std::int32_t id) override
+    {
+        std::vector<DoctorRow> rows =
+            doctors(exec("SELECT id, full_name, specialty, on_shift FROM doctors WHERE id = $1", {std::to_string(id)}));
+        if (rows.empty())
+            return std::nullopt;
+        return rows.front();
+    }
+
+    std::vector<DoctorRow> doctors_on_shift() override
+    {
+        return doctors(exec("SELECT id, full_name, specialty, on_shift FROM doctors WHERE on_shift", {}));
+    }
+
+    std::int64_t add_visit(const VisitRow& r) override
+    {
+        Result res = exec("INSERT INTO visits (patient_id, doctor_id, visit_time, duration_sec, status) "
+                          "VALUES ($1, $2, $3, $4, $5) RETURNING id",
+                          {std::to_string(r.patientId), std::to_string(r.doctorId), std::to_string(r.visitTime),
+                           std::to_string(r.durationSec), std::to_string(static_cast<int>(r.status))});
+        return toInt(res, 0, 0);
+    }
+
+    bool set_visit_status(std::int64_t visitId, VisitStatus status) override
+    {
+        return affected(exec("UPDATE visits SET status = $2 WHERE id = $1",
+                             {std::to_string(visitId), std::to_string(static_cast<int>(status))}));
+    }
+
+    std::vector<VisitRow> visits_of_patient(std::int64_t patientId) override
+    {
+        return visits(exec(kVisitColumns + std::string(" WHERE patient_id = $1"), {std::to_string(patientId)}));
+    }
+
+    std::vector<VisitRow> visits_of_doctor(std::int32_t doctorId) override
+    {
+        return visits(exec(kVisitColumns + std::string(" WHERE doctor_id = $1"), {std::to_string(doctorId)}));
+    }
+
+private:
+    struct ResultDeleter {
+        void operator()(PGresult* r) const { PQclear(r); }
+    };
+    using Result = std::unique_ptr<PGresult, ResultDeleter>;
+
+    static constexpr const char* kVisitColumns =
+        "SELECT id, patient_id, doctor_id, visit_time, duration_sec, status FROM visits";
+
+    Result exec(const std::string& sql, const std::vector<std::string>& params)
+    {
+        std::vector<const char*> values(params.size());
+        for (std::size_t i = 0; i < params.size(); ++i)
+            values[i] = params[i].c_str();
+        Result res(PQexecParams(conn_, sql.c_str(), static_cast<int>(params.size()), nullptr, values.data(), nullptr,
+                                nullptr, 0));
+        const ExecStatusType st = res ? PQresultStatus(res.get()) : PGRES_FATAL_ERROR;
+        if (st != PGRES_COMMAND_OK && st != PGRES_TUPLES_OK)
+            throw Error(std::string("PgStorage: ") + PQerrorMessage(conn_));
+        return res;
+    }
+
+    static bool affected(const Result& res) { return std::atoll(PQcmdTuples(res.get())) > 0; }
+
+    static std::int64_t toInt(const Result& res, int row, int col)
+    {
+        return std::strtoll(PQgetvalue(res.get(), row, col), nullptr, 10);
+    }
+
+    static std::vector<DoctorRow> doctors(const Result& res)
+    {
+        std::vector<DoctorRow> out(static_cast<std::size_t>(PQntuples(res.get())));
+        for (int i = 0; i < PQntuples(res.get()); ++i) {
+            DoctorRow& r = out[static_cast<std::size_t>(i)];
+            r.id = static_cast<std::int32_t>(toInt(res, i, 0));
+            r.fullName = PQgetvalue(res.get(), i, 1);
+            r.specialty = PQgetvalue(res.get(), i, 2);
+            r.onShift = PQgetvalue(res.get(), i, 3)[0] == 't';
+        }
+        return out;
+    }
+
+    static std::vector<VisitRow> visits(const Result& res)
+    {
+        std::vector<VisitRow> out(static_cast<std::size_t>(PQntuples(res.get())));
+        for (int i = 0; i < PQntuples(res.get()); ++i) {
+            VisitRow& r = out[static_cast<std::size_t>(i)];
+            r.id = toInt(res, i, 0);
+            r.patientId = toInt(res, i, 1);
+            r.doctorId = static_cast<std::int32_t>(toInt(res, i, 2));
+            r.visitTime = toInt(res, i, 3);
+            r.durationSec = static_cast<std::int32_t>(toInt(res, i, 4));
+            r.status = static_cast<VisitStatus>(toInt(res, i, 5));
+        }
+        return out;
+    }
+
+    PGconn* conn_;
+};
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Гистограмма задержек в стиле HDR: логарифмические "этажи" по степеням
+// двойки, внутри этажа — 16 линейных корзин (точность ~6%). Диапазон —
+// от 1 нс до ~36 минут. Запись — пара fetch_add без блокировок.
+class LatencyHistogram {
+public:
+    static constexpr unsigned    kSubBits    = 4;
+    static constexpr unsigned    kSubBuckets = 1u << kSubBits;
+    static constexpr unsigned    kMaxExp     = 40; // старший этаж — [2^40, 2^41) нс
+    static constexpr std::size_t kBuckets    = (kMaxExp - kSubBits + 2) * kSubBuckets;
+
+    void record(std::uint64_t nanos)
+    {
+        counts_[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(nanos, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    // Верхняя граница корзины, в которую попадает q-квантиль
+    std::uint64_t percentile(double q) const
+    {
+        const std::uint64_t n = count();
+        if (n == 0)
+            return 0;
+        const auto target = static_cast<std::uint64_t>(q * static_cast<double>(n - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            seen += counts_[b].load(std::memory_order_relaxed);
+            if (seen >= target)
+                return upperBound(b);
+        }
+        return upperBound(kBuckets - 1);
+    }
+
+    // Сколько замеров не больше limit (по верхним границам корзин)
+    std::uint64_t count_below(std::uint64_t limit) const
+    {
+        std::uint64_t n = 0;
+        for (std::size_t b = 0; b < kBuckets && upperBound(b) <= limit; ++b)
+            n += counts_[b].load(std::memory_order_relaxed);
+        return n;
+    }
+
+    static std::size_t bucketOf(std::uint64_t v)
+    {
+        if (v < kSubBuckets)
+            return static_cast<std::size_t>(v);
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        if (msb > kMaxExp)
+            return kBuckets - 1;
+        const unsigned shift = msb - kSubBits;
+        const std::size_t sub = static_cast<std::size_t>((v >> shift) & (kSubBuckets - 1));
+        return (shift + 1) * kSubBuckets + sub;
+    }
+
+    static std::uint64_t upperBound(std::size_t bucket)
+    {
+        if (bucket < kSubBuckets)
+            return bucket;
+        const unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+        const std::uint64_t sub = bucket % kSubBuckets;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> counts_{};
+    std::atomic<std::uint64_t>                       total_{0};
+    std::atomic<std::uint64_t>                       sum_{0};
+};
+
+// Метрики одного оператора DataBaseWorker (по имени prepared statement или метода)
+struct StatementStats {
+    explicit StatementStats(std::string statementName) : name(std::move(statementName)) {}
+
+    const std::string          name;
+    LatencyHistogram           latency;
+    std::atomic<std::uint64_t> rows{0};   // возвращено или затронуто
+    std::atomic<std::uint64_t> bytes{0};  // объём результата
+    std::atomic<std::uint64_t> errors{0};
+};
+
+// Кольцо последних медленных запросов. Текст хранится уже без значений:
+// строковые и числовые литералы заменены на '?', параметры $n не пишутся.
+class SlowQueryLog {
+public:
+    struct Entry {
+        std::chrono::system_clock::time_point at;
+        std::string                           statement;
+        std::string                           sql;
+        std::uint64_t                         nanos = 0;
+        std::uint64_t                         rows  = 0;
+    };
+
+    explicit SlowQueryLog(std::size_t capacity = 256) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    void add(std::string_view statement, std::string_view sql, std::uint64_t nanos, std::uint64_t rows)
+    {
+        Entry e{std::chrono::system_clock::now(), std::string(statement), redact(sql), nanos, rows};
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.size() == capacity_)
+            entries_.pop_front();
+        entries_.push_back(std::move(e));
+    }
+
+    std::vector<Entry> snapshot() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::vector<Entry>(entries_.begin(), entries_.end());
+    }
+
+    static std::string redact(std::string_view sql)
+    {
+        std::string out;
+        out.reserve(sql.size());
+        for (std::size_t i = 0; i < sql.size();) {
+            const char c = sql[i];
+            if (c == '\'') {
+                // строковый литерал, '' внутри — экранированная кавычка
+                ++i;
+                while (i < sql.size()) {
+                    if (sql[i] == '\'' && i + 1 < sql.size() && sql[i + 1] == '\'')
+                        i += 2;
+                    else if (sql[i++] == '\'')
+                        break;
+                }
+                out += '?';
+            } else if ((c >= '0' && c <= '9') && (out.empty() || !isIdentChar(out.back()))) {
+                while (i < sql.size() && ((sql[i] >= '0' && sql[i] <= '9') || sql[i] == '.'))
+                    ++i;
+                out += '?';
+            } else {
+                out += c;
+                ++i;
+            }
+        }
+        return out;
+    }
+
+private:
+    static bool isIdentChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+    }
+
+    const std::size_t   capacity_;
+    mutable std::mutex  mutex_;
+    std::deque<Entry>   entries_;
+};
+
+// Реестр метрик запросов DataBaseWorker и их выгрузка в текстовом формате Prometheus.
+// Поиск по имени (под shared_mutex) — только при регистрации оператора:
+// вызывающий один раз берёт statement(name) и дальше пишет в полученный
+// StatementStats без блокировок.
+class QueryMetrics {
+public:
+    explicit QueryMetrics(std::chrono::nanoseconds slowThreshold = std::chrono::milliseconds(100),
+                          std::size_t slowLogCapacity = 256)
+        : slowThreshold_(static_cast<std::uint64_t>(slowThreshold.count())), slowLog_(slowLogCapacity)
+    {
+    }
+
+    // Регистрация: ссылка стабильна всё время жизни реестра, её кэшируют у вызывающего
+    StatementStats& statement(const std::string& name)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = statements_.find(name);
+            if (it != statements_.end())
+                return *it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto& slot = statements_[name];
+        if (!slot)
+            slot = std::make_unique<StatementStats>(name);
+        return *slot;
+    }
+
+    // Горячий путь: только атомарные счётчики; строки копируются лишь для медленного запроса
+    void record(StatementStats& s, std::string_view sql, std::chrono::nanoseconds elapsed,
+                std::uint64_t rows, std::uint64_t bytes, bool failed = false)
+    {
+        const auto nanos = static_cast<std::uint64_t>(elapsed.count() < 0 ? 0 : elapsed.count());
+        s.latency.record(nanos);
+        s.rows.fetch_add(rows, std::memory_order_relaxed);
+        s.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        if (failed)
+            s.errors.fetch_add(1, std::memory_order_relaxed);
+        if (nanos >= slowThreshold_)
+            slowLog_.add(s.name, sql, nanos, rows);
+    }
+
+    const SlowQueryLog& slow_log() const { return slowLog_; }
+
+    std::string prometheus() const
+    {
+        static const double kBounds[] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                         0.025,  0.05,    0.1,    0.25,  0.5,    1.0,   2.5, 5.0, 10.0};
+        std::ostringstream os;
+        os << "# TYPE db_query_duration_seconds histogram\n";
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& entry : statements_) {
+            const std::string label = "statement=\"" + escapeLabel(entry.first) + "\"";
+            const LatencyHistogram& h = entry.second->latency;
+            for (double le : kBounds)
+                os << "db_query_duration_seconds_bucket{" << label << ",le=\"" << le << "\"} "
+                   << h.count_below(static_cast<std::uint64_t>(le * 1e9)) << '\n';
+            os << "db_query_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << h.count() << '\n';
+            os << "db_query_duration_seconds_sum{" << label << "} " << static_cast<double>(h.sum()) / 1e9 << '\n';
+            os << "db_query_duration_seconds_count{" << label << "} " << h.count() << '\n';
+        }
+        os << "# TYPE db_query_rows_total counter\n";
+        for (const auto& entry : statements_)
+            os << "db_query_rows_total{statement=\"" << escapeLabel(entry.first) << "\"} "
+               << entry.second->rows.load(std::memory_order_relaxed) << '\n';
+        os << "# TYPE db_query_bytes_total counter\n";
+        for (const auto& entry : statements_)
+            os << "db_query_bytes_total{statement=\"" << escapeLabel(entry.first) << "\"} "
+               << entry.second->bytes.load(std::memory_order_relaxed) << '\n';
+        os << "# TYPE db_query_errors_total counter\n";
+        for (const auto& entry : statements_)
+            os << "db_query_errors_total{statement=\"" << escapeLabel(entry.first) << "\"} "
+               << entry.second->errors.load(std::memory_order_relaxed) << '\n';
+        return os.str();
+    }
+
+    // Атомарная запись снимка в файл (для textfile-коллектора node_exporter)
+    void write_file(const std::string& path) const
+    {
+        const std::string text = prometheus();
+        const std::string tmp = path + ".tmp";
+        std::FILE* f = std::fopen(tmp.c_str(), "w");
+        if (!f)
+            throw std::system_error(errno, std::generic_category(), "QueryMetrics: open " + tmp);
+        const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        if (std::fclose(f) != 0 || !ok)
+            throw std::system_error(errno, std::generic_category(), "QueryMetrics: write " + tmp);
+        if (std::rename(tmp.c_str(), path.c_str()) != 0)
+            throw std::system_error(errno, std::generic_category(), "QueryMetrics: rename " + tmp);
+    }
+
+    // Отправка снимка локальному сборщику, слушающему Unix-сокет
+    void send_unix(const std::string& socketPath) const
+    {
+        sockaddr_un addr{};
+        if (socketPath.size() >= sizeof(addr.sun_path))
+            throw std::invalid_argument("QueryMetrics: socket path too long");
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "QueryMetrics: socket");
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "QueryMetrics: connect " + socketPath);
+        }
+
+        const std::string text = prometheus();
+        std::size_t sent = 0;
+        while (sent < text.size()) {
+            const ssize_t n = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0) {
+                const int err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), "QueryMetrics: send " + socketPath);
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        ::close(fd);
+    }
+
+private:
+    static std::string escapeLabel(const std::string& s)
+    {
+        std::string out;
+        for (char c : s) {
+            if (c == '\\' || c == '"')
+                out += '\\';
+            if (c == '\n') {
+                out += "\\n";
+                continue;
+            }
+            out += c;
+        }
+        return out;
+    }
+
+    const std::uint64_t                                     slowThreshold_;
+    SlowQueryLog                                            slowLog_;
+    mutable std::shared_mutex                               mutex_;
+    std::map<std::string, std::unique_ptr<StatementStats>>  statements_;
+};
+
+// RAII-замер одного вызова: rows/bytes заполняются по ходу, запись — в деструкторе.
+// stats — закэшированный metrics.statement(name); sql не копируется и должен
+// жить дольше таймера (обычно это строка prepared statement или литерал).
+class ScopedQueryTimer {
+public:
+    ScopedQueryTimer(QueryMetrics& metrics, StatementStats& stats, std::string_view sql = {})
+        : metrics_(metrics), stats_(stats), sql_(sql), start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ScopedQueryTimer(const ScopedQueryTimer&)            = delete;
+    ScopedQueryTimer& operator=(const ScopedQueryTimer&) = delete;
+
+    ~ScopedQueryTimer()
+    {
+        metrics_.record(stats_, sql_, std::chrono::steady_clock::now() - start_, rows, bytes,
+                        std::uncaught_exceptions() > uncaught_);
+    }
+
+    std::uint64_t rows  = 0;
+    std::uint64_t bytes = 0;
+
+private:
+    QueryMetrics&                         metrics_;
+    StatementStats&                       stats_;
+    std::string_view                      sql_;
+    std::chrono::steady_clock::time_point start_;
+    int                                   uncaught_ = std::uncaught_exceptions();
+};
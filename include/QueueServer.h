@@ -0,0 +1,362 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Бинарный протокол сервера очереди: кадры фиксированной длины,
+// порядок байт — хостовый (сокет только локальный).
+//
+// Запрос, 24 байта:  op u8 | triage u8 | 0 u16 | tag u32 | doctor u32 | 0 u32 | patientId u64
+// Ответ,  16 байт:   status u8 | 0 u8[3] | tag u32 | value u64
+//
+// tag клиент выбирает сам и получает обратно — по нему сопоставляются
+// ответы при конвейерной отправке. value: для Dequeue — id пациента,
+// для Status — позиция в очереди (0 — следующий).
+namespace queue_proto {
+
+enum class Op : std::uint8_t { Enqueue = 1, Dequeue = 2, Status = 3, Cancel = 4 };
+
+enum class Status : std::uint8_t { Ok = 0, NotFound = 1, Empty = 2, BadRequest = 3, Error = 4 };
+
+struct Request {
+    Op            op = Op::Status;
+    std::uint8_t  triage = 0;
+    std::uint32_t tag = 0;
+    std::uint32_t doctor = 0;
+    std::uint64_t patientId = 0;
+};
+
+struct Response {
+    Status        status = Status::Ok;
+    std::uint32_t tag = 0;
+    std::uint64_t value = 0;
+};
+
+constexpr std::size_t kRequestSize  = 24;
+constexpr std::size_t kResponseSize = 16;
+
+inline void encode(const Request& r, char* out)
+{
+    std::memset(out, 0, kRequestSize);
+    out[0] = static_cast<char>(r.op);
+    out[1] = static_cast<char>(r.triage);
+    std::memcpy(out + 4, &r.tag, 4);
+    std::memcpy(out + 8, &r.doctor, 4);
+    std::memcpy(out + 16, &r.patientId, 8);
+}
+
+inline Request decode_request(const char* in)
+{
+    Request r;
+    r.op = static_cast<Op>(static_cast<std::uint8_t>(in[0]));
+    r.triage = static_cast<std::uint8_t>(in[1]);
+    std::memcpy(&r.tag, in + 4, 4);
+    std::memcpy(&r.doctor, in + 8, 4);
+    std::memcpy(&r.patientId, in + 16, 8);
+    return r;
+}
+
+inline void encode(const Response& r, char* out)
+{
+    std::memset(out, 0, kResponseSize);
+    out[0] = static_cast<char>(r.status);
+    std::memcpy(out + 4, &r.tag, 4);
+    std::memcpy(out + 8, &r.value, 8);
+}
+
+inline Response decode_response(const char* in)
+{
+    Response r;
+    r.status = static_cast<Status>(static_cast<std::uint8_t>(in[0]));
+    std::memcpy(&r.tag, in + 4, 4);
+    std::memcpy(&r.value, in + 8, 8);
+    return r;
+}
+
+inline bool valid(Op op)
+{
+    return op == Op::Enqueue || op == Op::Dequeue || op == Op::Status || op == Op::Cancel;
+}
+
+} // namespace queue_proto
+
+// Долгоживущий сервер очереди на Unix-сокете: один поток, epoll,
+// неблокирующие сокеты. За одно пробуждение читает всё, что пришло
+// со всех соединений, и отдаёт обработчику одной пачкой — очередь
+// блокируется один раз на пачку, а ответы уходят одним write на соединение.
+//
+// Handler — любой тип с методом
+//   void handle(const queue_proto::Request* requests, queue_proto::Response* responses, std::size_t n);
+// responses[i].tag заполнен заранее; обработчик выставляет status и value.
+template <typename Handler>
+class QueueServer {
+public:
+    struct Stats {
+        std::uint64_t requests    = 0;
+        std::uint64_t batches     = 0;
+        std::uint64_t connections = 0;
+    };
+
+    QueueServer(std::string path, Handler& handler, std::size_t maxBatch = 4096)
+        : path_(std::move(path)), handler_(handler), maxBatch_(maxBatch ? maxBatch : 1)
+    {
+        sockaddr_un addr{};
+        if (path_.size() >= sizeof(addr.sun_path))
+            throw std::invalid_argument("QueueServer: socket path is too long");
+
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wakeFd_  = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (epollFd_ < 0 || wakeFd_ < 0 || listenFd_ < 0)
+            fail("QueueServer: setup failed");
+
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path_.c_str(), path_.size() + 1);
+        ::unlink(path_.c_str()); // сокет от прошлого запуска
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+            fail("QueueServer: bind " + path_);
+        if (::listen(listenFd_, SOMAXCONN) != 0)
+            fail("QueueServer: listen");
+
+        watch(listenFd_, EPOLLIN, EPOLL_CTL_ADD);
+        watch(wakeFd_, EPOLLIN, EPOLL_CTL_ADD);
+    }
+
+    QueueServer(const QueueServer&)            = delete;
+    QueueServer& operator=(const QueueServer&) = delete;
+
+    ~QueueServer()
+    {
+        for (auto& entry : conns_)
+            ::close(entry.first);
+        closeFds();
+        ::unlink(path_.c_str());
+    }
+
+    // Крутит цикл событий до stop()
+    void run()
+    {
+        std::vector<epoll_event> events(256);
+        while (!stopping_.load(std::memory_order_acquire)) {
+            const int n = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "QueueServer: epoll_wait");
+            }
+            for (int i = 0; i < n; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == listenFd_) {
+                    accept();
+                } else if (fd == wakeFd_) {
+                    std::uint64_t drained = 0;
+                    [[maybe_unused]] ssize_t r = ::read(wakeFd_, &drained, sizeof(drained));
+                } else {
+                    auto it = conns_.find(fd);
+                    if (it == conns_.end())
+                        continue;
+                    if (events[i].events & EPOLLOUT)
+                        writeOut(fd, it->second);
+                    if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                        readIn(fd, it->second);
+                }
+            }
+            processBatch();
+        }
+    }
+
+    // Потокобезопасно
+    void stop()
+    {
+        stopping_.store(true, std::memory_order_release);
+        const std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    // Больше этого в исходящем буфере — перестаём читать соединение, пока клиент не заберёт ответы
+    static constexpr std::size_t kMaxPendingOut = 1 << 20;
+    static constexpr std::size_t kReadChunk     = 64 * 1024;
+
+    struct Conn {
+        std::vector<char> in;
+        std::vector<char> out;
+        std::size_t       outOffset = 0;
+        std::uint32_t     interest = EPOLLIN;
+        bool              closed = false;
+    };
+
+    [[noreturn]] void fail(const std::string& what)
+    {
+        const int err = errno;
+        closeFds();
+        throw std::system_error(err, std::generic_category(), what);
+    }
+
+    void closeFds()
+    {
+        for (int* fd : {&listenFd_, &wakeFd_, &epollFd_}) {
+            if (*fd >= 0)
+                ::close(*fd);
+            *fd = -1;
+        }
+    }
+
+    void watch(int fd, std::uint32_t events, int op)
+    {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd_, op, fd, &ev);
+    }
+
+    void accept()
+    {
+        for (;;) {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return; // EAGAIN или временная ошибка — остальное примем на следующем пробуждении
+            conns_.emplace(fd, Conn{});
+            watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+            ++stats_.connections;
+        }
+    }
+
+    void readIn(int fd, Conn& c)
+    {
+        if (c.closed || c.out.size() - c.outOffset >= kMaxPendingOut)
+            return;
+        const std::size_t old = c.in.size();
+        c.in.resize(old + kReadChunk);
+        const ssize_t n = ::read(fd, c.in.data() + old, kReadChunk);
+        if (n <= 0) {
+            c.in.resize(old);
+            if (n == 0 || (errno != EAGAIN && errno != EINTR))
+                c.closed = true;
+            return;
+        }
+        c.in.resize(old + static_cast<std::size_t>(n));
+
+        const std::size_t frames = c.in.size() / queue_proto::kRequestSize;
+        const char* p = c.in.data();
+        for (std::size_t i = 0; i < frames; ++i, p += queue_proto::kRequestSize) {
+            batch_.push_back(queue_proto::decode_request(p));
+            owners_.push_back(fd);
+        }
+        c.in.erase(c.in.begin(), c.in.begin() + static_cast<std::ptrdiff_t>(frames * queue_proto::kRequestSize));
+    }
+
+    void processBatch()
+    {
+        if (!batch_.empty()) {
+            responses_.assign(batch_.size(), queue_proto::Response{});
+            for (std::size_t i = 0; i < batch_.size(); ++i)
+                responses_[i].tag = batch_[i].tag;
+
+            // Некорректные кадры отвечаем сами, обработчик получает только валидные
+            std::size_t begin = 0;
+            for (std::size_t i = 0; i <= batch_.size(); ++i) {
+                const bool bad = i < batch_.size() && !queue_proto::valid(batch_[i].op);
+                if (i == batch_.size() || bad) {
+                    for (std::size_t from = begin; from < i; from += maxBatch_) {
+                        const std::size_t n = std::min(maxBatch_, i - from);
+                        handler_.handle(batch_.data() + from, responses_.data() + from, n);
+                        ++stats_.batches;
+                    }
+                    if (bad)
+                        responses_[i].status = queue_proto::Status::BadRequest;
+                    begin = i + 1;
+                }
+            }
+            stats_.requests += batch_.size();
+
+            for (std::size_t i = 0; i < batch_.size(); ++i) {
+                Conn& c = conns_.at(owners_[i]);
+                const std::size_t at = c.out.size();
+                c.out.resize(at + queue_proto::kResponseSize);
+                queue_proto::encode(responses_[i], c.out.data() + at);
+            }
+        }
+
+        for (int fd : owners_) {
+            auto it = conns_.find(fd);
+            if (it != conns_.end() && it->second.outOffset < it->second.out.size())
+                writeOut(fd, it->second);
+        }
+        batch_.clear();
+        owners_.clear();
+
+        for (auto it = conns_.begin(); it != conns_.end();) {
+            if (it->second.closed) {
+                ::close(it->first); // закрытие снимает fd и с epoll
+                it = conns_.erase(it);
+            } else {
+                updateInterest(it->first, it->second);
+                ++it;
+            }
+        }
+    }
+
+    void writeOut(int fd, Conn& c)
+    {
+        while (c.outOffset < c.out.size()) {
+            const ssize_t n = ::send(fd, c.out.data() + c.outOffset, c.out.size() - c.outOffset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno != EAGAIN)
+                    c.closed = true;
+                break;
+            }
+            c.outOffset += static_cast<std::size_t>(n);
+        }
+        if (c.outOffset == c.out.size()) {
+            c.out.clear();
+            c.outOffset = 0;
+        }
+    }
+
+    void updateInterest(int fd, Conn& c)
+    {
+        const std::size_t pending = c.out.size() - c.outOffset;
+        std::uint32_t want = 0;
+        if (pending > 0)
+            want |= EPOLLOUT;
+        if (pending < kMaxPendingOut)
+            want |= EPOLLIN;
+        if (want != c.interest) {
+            watch(fd, want, EPOLL_CTL_MOD);
+            c.interest = want;
+        }
+    }
+
+    std::string                        path_;
+    Handler&                           handler_;
+    std::size_t                        maxBatch_;
+    int                                epollFd_  = -1;
+    int                                wakeFd_   = -1;
+    int                                listenFd_ = -1;
+    std::atomic<bool>                  stopping_{false};
+    std::unordered_map<int, Conn>      conns_;
+    std::vector<queue_proto::Request>  batch_;
+    std::vector<queue_proto::Response> responses_;
+    std::vector<int>                   owners_;
+    Stats                              stats_;
+};
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "AvailabilityCalendar.h"
+#include "WriteAheadLog.h"
+
+// Бинарный снимок состояния очереди для тёплого старта за доли секунды
+// вместо многоминутной пересборки из БД.
+//
+// Файл: заголовок (магия, версия, lsn, время снимка), таблица секций и
+// сами секции — массивы тривиально копируемых записей, выровненные на
+// 64 байта. После mmap читатель получает указатели прямо в файл, без
+// разбора и копирования. Заголовок, таблица и каждая секция защищены CRC32.
+//
+// Восстановление: загрузить снимок, затем доиграть изменения после него —
+// записи WriteAheadLog с lsn > lsn(), либо строки БД, изменённые после
+// timestamp(). Снимок пишется во временный файл и подменяется через rename,
+// так что на диске всегда лежит целый снимок — старый или новый.
+namespace snapshot {
+
+// Стандартные секции; id свыше 1000 свободны для прочих данных
+enum Section : std::uint32_t {
+    QueueEntries        = 1, // очередь пациентов в порядке обслуживания
+    DoctorSchedules     = 2, // сетки календарей врачей (DoctorSchedule)
+    ActiveVisits        = 3, // незакрытые визиты
+    DoctorScheduleWords = 4, // слова битовых карт всех календарей подряд
+};
+
+constexpr char          kMagic[8] = {'P', 'Q', 'S', 'N', 'A', 'P', '\0', '\x01'};
+constexpr std::uint32_t kVersion  = 1;
+constexpr std::size_t   kAlign    = 64;
+
+struct Header {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t sections;
+    std::uint64_t lsn;
+    std::int64_t  timestamp;
+    std::uint64_t fileSize;
+    std::uint32_t tableCrc;
+    std::uint32_t headerCrc; // по всем предыдущим полям
+};
+
+struct SectionEntry {
+    std::uint32_t id;
+    std::uint32_t recordSize;
+    std::uint64_t count;
+    std::uint64_t offset;
+    std::uint32_t crc;
+    std::uint32_t reserved;
+};
+
+// Календарь врача: сетка и место его слов в секции DoctorScheduleWords
+struct DoctorSchedule {
+    std::int64_t  doctorId;
+    std::int64_t  start;
+    std::int64_t  slotSeconds;
+    std::uint64_t slots;
+    std::uint64_t firstWord;
+    std::uint64_t wordCount;
+};
+
+static_assert(sizeof(Header) == 48 && sizeof(SectionEntry) == 32 && sizeof(DoctorSchedule) == 48,
+              "snapshot layout must not depend on padding");
+
+inline std::size_t aligned(std::size_t n)
+{
+    return (n + kAlign - 1) / kAlign * kAlign;
+}
+
+} // namespace snapshot
+
+class SnapshotWriter {
+public:
+    SnapshotWriter(std::uint64_t lsn, std::int64_t timestamp) : lsn_(lsn), timestamp_(timestamp) {}
+
+    // Данные копируются сразу: снимок согласован на момент add()
+    template <typename T>
+    void add(std::uint32_t id, const T* records, std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshot records must be trivially copyable");
+        static_assert(alignof(T) <= snapshot::kAlign, "snapshot records are aligned to 64 bytes at most");
+        for (const Pending& p : sections_)
+            if (p.id == id)
+                throw std::invalid_argument("SnapshotWriter: duplicate section " + std::to_string(id));
+
+        Pending p;
+        p.id = id;
+        p.recordSize = static_cast<std::uint32_t>(sizeof(T));
+        p.count = count;
+        p.bytes.resize(sizeof(T) * count);
+        if (count != 0)
+            std::memcpy(p.bytes.data(), records, p.bytes.size());
+        sections_.push_back(std::move(p));
+    }
+
+    template <typename T>
+    void add(std::uint32_t id, const std::vector<T>& records)
+    {
+        add(id, records.data(), records.size());
+    }
+
+    void write(const std::string& path) const
+    {
+        using namespace snapshot;
+
+        std::vector<SectionEntry> table(sections_.size());
+        std::size_t offset = aligned(sizeof(Header) + sizeof(SectionEntry) * table.size());
+        for (std::size_t i = 0; i < sections_.size(); ++i) {
+            const Pending& p = sections_[i];
+            table[i] = SectionEntry{p.id, p.recordSize, p.count, offset,
+                                    WriteAheadLog::crc32(p.bytes.data(), p.bytes.size()), 0};
+            offset = aligned(offset + p.bytes.size());
+        }
+
+        Header h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.sections = static_cast<std::uint32_t>(table.size());
+        h.lsn = lsn_;
+        h.timestamp = timestamp_;
+        h.fileSize = offset;
+        h.tableCrc = WriteAheadLog::crc32(table.data(), sizeof(SectionEntry) * table.size());
+        h.headerCrc = WriteAheadLog::crc32(&h, offsetof(Header, headerCrc));
+
+        std::vector<char> head(aligned(sizeof(Header) + sizeof(SectionEntry) * table.size()), 0);
+        std::memcpy(head.data(), &h, sizeof(h));
+        if (!table.empty())
+            std::memcpy(head.data() + sizeof(h), table.data(), sizeof(SectionEntry) * table.size());
+
+        const std::string tmp = path + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throwErrno("open " + tmp);
+        try {
+            static const char zeros[kAlign] = {};
+            writeAll(fd, head.data(), head.size(), tmp);
+            for (const Pending& p : sections_) {
+                writeAll(fd, p.bytes.data(), p.bytes.size(), tmp);
+                writeAll(fd, zeros, aligned(p.bytes.size()) - p.bytes.size(), tmp);
+            }
+            if (::fsync(fd) != 0)
+                throwErrno("fsync " + tmp);
+        } catch (...) {
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            throw;
+        }
+        ::close(fd);
+
+        if (::rename(tmp.c_str(), path.c_str()) != 0)
+            throwErrno("rename " + tmp);
+        syncDirectory(path);
+    }
+
+private:
+    struct Pending {
+        std::uint32_t     id = 0;
+        std::uint32_t     recordSize = 0;
+        std::uint64_t     count = 0;
+        std::vector<char> bytes;
+    };
+
+    static void writeAll(int fd, const char* data, std::size_t size, const std::string& what)
+    {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throwErrno("write " + what);
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+
+    static void syncDirectory(const std::string& path)
+    {
+        const auto slash = path.rfind('/');
+        const std::string dir = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            throwErrno("open " + dir);
+        const int rc = ::fsync(fd);
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        if (rc != 0)
+            throwErrno("fsync " + dir);
+    }
+
+    [[noreturn]] static void throwErrno(const std::string& what)
+    {
+        throw std::system_error(errno, std::generic_category(), "SnapshotWriter: " + what);
+    }
+
+    std::uint64_t        lsn_;
+    std::int64_t         timestamp_;
+    std::vector<Pending> sections_;
+};
+
+// Снимок, отображённый в память только для чтения. Секции живут, пока жив reader.
+// Битый, обрезанный или чужой файл — std::runtime_error: тогда стартуем по-старому, из БД.
+class SnapshotReader {
+public:
+    template <typename T>
+    struct View {
+        const T*    data = nullptr;
+        std::size_t count = 0;
+
+        const T*    begin() const { return data; }
+        const T*    end() const { return data + count; }
+        std::size_t size() const { return count; }
+        bool        empty() const { return count == 0; }
+        const T&    operator[](std::size_t i) const { return data[i]; }
+    };
+
+    // verify = false пропускает CRC секций (заголовок и таблица проверяются всегда)
+    explicit SnapshotReader(const std::string& path, bool verify = true)
+    {
+        using namespace snapshot;
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "SnapshotReader: open " + path);
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "SnapshotReader: fstat " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error("SnapshotReader: truncated snapshot " + path);
+        }
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int err = errno;
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw std::system_error(err, std::generic_category(), "SnapshotReader: mmap " + path);
+        base_ = static_cast<const char*>(p);
+        ::madvise(p, size_, MADV_WILLNEED);
+
+        try {
+            validate(path, verify);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    SnapshotReader(SnapshotReader&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)), size_(std::exchange(other.size_, 0)),
+          header_(other.header_), table_(std::exchange(other.table_, nullptr))
+    {
+    }
+    SnapshotReader& operator=(SnapshotReader&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            base_ = std::exchange(other.base_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            header_ = other.header_;
+            table_ = std::exchange(other.table_, nullptr);
+        }
+        return *this;
+    }
+    SnapshotReader(const SnapshotReader&)            = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    ~SnapshotReader() { unmap(); }
+
+    std::uint64_t lsn() const { return header_.lsn; }
+    std::int64_t  timestamp() const { return header_.timestamp; }
+
+    bool has(std::uint32_t id) const { return find(id) != nullptr; }
+
+    template <typename T>
+    View<T> section(std::uint32_t id) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshot records must be trivially copyable");
+        const snapshot::SectionEntry* e = find(id);
+        if (!e)
+            throw std::out_of_range("SnapshotReader: no section " + std::to_string(id));
+        if (e->recordSize != sizeof(T))
+            throw std::runtime_error("SnapshotReader: record size mismatch in section " + std::to_string(id));
+        return View<T>{reinterpret_cast<const T*>(base_ + e->offset), static_cast<std::size_t>(e->count)};
+    }
+
+private:
+    void validate(const std::string& path, bool verify)
+    {
+        using namespace snapshot;
+
+        std::memcpy(&header_, base_, sizeof(Header));
+        if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0)
+            throw std::runtime_error("SnapshotReader: not a snapshot " + path);
+        if (header_.version != kVersion)
+            throw std::runtime_error("SnapshotReader: unsupported snapshot version " + std::to_string(header_.version));
+        if (WriteAheadLog::crc32(&header_, offsetof(Header, headerCrc)) != header_.headerCrc)
+            throw std::runtime_error("SnapshotReader: corrupted header " + path);
+        if (header_.fileSize != size_)
+            throw std::runtime_error("SnapshotReader: truncated snapshot " + path);
+
+        const std::size_t tableBytes = sizeof(SectionEntry) * header_.sections;
+        if (header_.sections > (size_ - sizeof(Header)) / sizeof(SectionEntry))
+            throw std::runtime_error("SnapshotReader: corrupted section table " + path);
+        table_ = reinterpret_cast<const SectionEntry*>(base_ + sizeof(Header));
+        if (WriteAheadLog::crc32(table_, tableBytes) != header_.tableCrc)
+            throw std::runtime_error("SnapshotReader: corrupted section table " + path);
+
+        for (std::uint32_t i = 0; i < header_.sections; ++i) {
+            const SectionEntry& e = table_[i];
+            const std::uint64_t bytes = e.recordSize * e.count;
+            if (e.offset % kAlign != 0 || e.offset > size_ || (e.recordSize && e.count > (size_ - e.offset) / e.recordSize))
+                throw std::runtime_error("SnapshotReader: section out of bounds in " + path);
+            if (verify && WriteAheadLog::crc32(base_ + e.offset, bytes) != e.crc)
+                throw std::runtime_error("SnapshotReader: corrupted section " + std::to_string(e.id) + " in " + path);
+        }
+    }
+
+    const snapshot::SectionEntry* find(std::uint32_t id) const
+    {
+        for (std::uint32_t i = 0; i < header_.sections; ++i)
+            if (table_[i].id == id)
+                return &table_[i];
+        return nullptr;
+    }
+
+    void unmap()
+    {
+        if (base_)
+            ::munmap(const_cast<char*>(base_), size_);
+        base_ = nullptr;
+    }
+
+    const char*                   base_ = nullptr;
+    std::size_t                   size_ = 0;
+    snapshot::Header              header_{};
+    const snapshot::SectionEntry* table_ = nullptr;
+};
+
+namespace snapshot {
+
+// Календари врачей в секции DoctorSchedules + DoctorScheduleWords
+inline void add_schedules(SnapshotWriter& writer,
+                          const std::vector<std::pair<std::int64_t, AvailabilityCalendar>>& calendars)
+{
+    std::vector<DoctorSchedule> schedules;
+    std::vector<std::uint64_t>  words;
+    schedules.reserve(calendars.size());
+    for (const auto& [doctorId, calendar] : calendars) {
+        const std::vector<std::uint64_t>& w = calendar.words();
+        schedules.push_back(DoctorSchedule{doctorId, calendar.start(), calendar.slot_seconds(), calendar.slots(),
+                                           words.size(), w.size()});
+        words.insert(words.end(), w.begin(), w.end());
+    }
+    writer.add(DoctorSchedules, schedules);
+    writer.add(DoctorScheduleWords, words);
+}
+
+// Пусто, если секций нет; несогласованные секции — std::runtime_error
+inline std::vector<std::pair<std::int64_t, AvailabilityCalendar>> load_schedules(const SnapshotReader& reader)
+{
+    std::vector<std::pair<std::int64_t, AvailabilityCalendar>> out;
+    if (!reader.has(DoctorSchedules))
+        return out;
+    const auto schedules = reader.section<DoctorSchedule>(DoctorSchedules);
+    const auto words = reader.section<std::uint64_t>(DoctorScheduleWords);
+    out.reserve(schedules.size());
+    for (const DoctorSchedule& s : schedules) {
+        if (s.firstWord > words.size() || s.wordCount > words.size() - s.firstWord)
+            throw std::runtime_error("load_schedules: calendar words out of bounds");
+        std::vector<std::uint64_t> w(words.begin() + s.firstWord, words.begin() + s.firstWord + s.wordCount);
+        try {
+            out.emplace_back(s.doctorId, AvailabilityCalendar::from_words(s.start, s.slotSeconds,
+                                                                          static_cast<std::size_t>(s.slots),
+                                                                          std::move(w)));
+        } catch (const std::invalid_argument& e) {
+            throw std::runtime_error(std::string("load_schedules: ") + e.what());
+        }
+    }
+    return out;
+}
+
+} // namespace snapshot
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// memory_resource-обёртка, считающая обращения к вышестоящему ресурсу
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream)
+    {
+    }
+
+    std::uint64_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+    std::uint64_t deallocations() const { return deallocations_.load(std::memory_order_relaxed); }
+    std::uint64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream_;
+    std::atomic<std::uint64_t> allocations_{0};
+    std::atomic<std::uint64_t> deallocations_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+};
+
+// Арена на один запрос (dequeue-and-assign и т.п.): временные Patient,
+// Visit, Doctor, строки и контейнеры берут память сдвигом указателя и
+// освобождаются разом в release(). Арена живёт на рабочем потоке и
+// переиспользуется: начальный буфер выделяется один раз, поэтому типичный
+// запрос не обращается к куче вовсе.
+//
+// Контейнеры — std::pmr::* с resource() арены. Объекты через make<T>():
+// pmr-aware типы получают аллокатор арены автоматически (uses-allocator),
+// а деструкторы нетривиальных типов вызываются в release() в обратном порядке.
+class RequestArena {
+public:
+    template <typename T>
+    using Vector = std::pmr::vector<T>;
+    using String = std::pmr::string;
+
+    explicit RequestArena(std::size_t initialBytes = 16 * 1024,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : buffer_(new std::byte[initialBytes]), size_(initialBytes), upstream_(upstream),
+          arena_(buffer_.get(), size_, &upstream_)
+    {
+    }
+
+    RequestArena(const RequestArena&)            = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    ~RequestArena() { release(); }
+
+    std::pmr::memory_resource* resource() { return &arena_; }
+
+    template <typename T>
+    std::pmr::polymorphic_allocator<T> allocator()
+    {
+        return std::pmr::polymorphic_allocator<T>(&arena_);
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+        std::pmr::polymorphic_allocator<T> alloc(&arena_);
+        T* p = alloc.allocate(1);
+        alloc.construct(p, std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            auto* node = static_cast<Cleanup*>(arena_.allocate(sizeof(Cleanup), alignof(Cleanup)));
+            cleanups_ = new (node) Cleanup{[](void* obj) { static_cast<T*>(obj)->~T(); }, p, cleanups_};
+        }
+        return p;
+    }
+
+    String string(std::string_view s) { return String(s, &arena_); }
+
+    // Конец запроса: деструкторы make<T>() и сброс арены к начальному буферу
+    void release()
+    {
+        for (Cleanup* c = cleanups_; c; c = c->next)
+            c->destroy(c->object);
+        cleanups_ = nullptr;
+        arena_.release();
+    }
+
+    // Сколько раз арена ходила за памятью наверх — в норме 0 на запрос
+    std::uint64_t upstream_allocations() const { return upstream_.allocations(); }
+    std::size_t   initial_bytes() const { return size_; }
+
+private:
+    struct Cleanup {
+        void (*destroy)(void*);
+        void*    object;
+        Cleanup* next;
+    };
+
+    std::unique_ptr<std::byte[]>        buffer_;
+    std::size_t                         size_;
+    CountingResource                    upstream_;
+    std::pmr::monotonic_buffer_resource arena_;
+    Cleanup*                            cleanups_ = nullptr;
+};
+
+// RAII: арена сбрасывается по выходу из обработчика запроса
+class ArenaScope {
+public:
+    explicit ArenaScope(RequestArena& arena) : arena_(arena) {}
+    ArenaScope(const ArenaScope&)            = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+    ~ArenaScope() { arena_.release(); }
+
+private:
+    RequestArena& arena_;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Очередь пациентов, разбитая на шарды (по врачу или отделению).
+// У каждого шарда своя блокировка и своя куча, поэтому регистратуры и
+// врачи разных шардов не конкурируют за один мьютекс. Освободившийся
+// врач может забрать подходящего пациента из самого загруженного шарда.
+//
+// Первым выходит наименьший элемент (меньший приоритет срочнее, как
+// в IndexedDaryHeap). Compare — как у std::priority_queue.
+template <typename T, typename Compare = std::greater<T>>
+class ShardedQueue {
+public:
+    explicit ShardedQueue(std::size_t shards, Compare compare = Compare())
+        : shards_(shards), compare_(std::move(compare))
+    {
+        if (shards == 0)
+            throw std::invalid_argument("ShardedQueue: at least one shard is required");
+    }
+
+    std::size_t shard_count() const { return shards_.size(); }
+
+    std::size_t size(std::size_t shard) const
+    {
+        return at(shard).size.load(std::memory_order_relaxed);
+    }
+
+    std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (const Shard& s : shards_)
+            total += s.size.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void push(std::size_t shard, T value)
+    {
+        Shard& s = at(shard);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.heap.push_back(std::move(value));
+        std::push_heap(s.heap.begin(), s.heap.end(), compare_);
+        s.size.store(s.heap.size(), std::memory_order_relaxed);
+    }
+
+    // Забирает лучшего пациента только из своего шарда
+    std::optional<T> pop(std::size_t shard)
+    {
+        Shard& s = at(shard);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.heap.empty())
+            return std::nullopt;
+        std::pop_heap(s.heap.begin(), s.heap.end(), compare_);
+        return takeBack(s);
+    }
+
+    // Свой шард, а если он пуст — кража у других шардов, начиная с самого
+    // загруженного. eligible(const T&) отсекает пациентов, которых этот
+    // врач принять не может (другая специальность и т.п.).
+    template <typename Eligible>
+    std::optional<T> pop_or_steal(std::size_t shard, Eligible&& eligible)
+    {
+        if (auto own = pop(shard))
+            return own;
+
+        std::vector<std::pair<std::size_t, std::size_t>> victims;
+        victims.reserve(shards_.size());
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            const std::size_t n = shards_[i].size.load(std::memory_order_relaxed);
+            if (i != shard && n > 0)
+                victims.emplace_back(n, i);
+        }
+        std::sort(victims.begin(), victims.end(), std::greater<>());
+
+        for (const auto& victim : victims)
+            if (auto stolen = stealFrom(shards_[victim.second], eligible))
+                return stolen;
+        return std::nullopt;
+    }
+
+    std::optional<T> pop_or_steal(std::size_t shard)
+    {
+        return pop_or_steal(shard, [](const T&) { return true; });
+    }
+
+private:
+    // Шард на отдельной кэш-линии, чтобы соседние мьютексы не ложно-разделялись
+    struct alignas(64) Shard {
+        mutable std::mutex       mutex;
+        std::vector<T>           heap;
+        std::atomic<std::size_t> size{0};
+    };
+
+    Shard& at(std::size_t shard)
+    {
+        if (shard >= shards_.size())
+            throw std::out_of_range("ShardedQueue: shard index out of range");
+        return shards_[shard];
+    }
+
+    const Shard& at(std::size_t shard) const
+    {
+        if (shard >= shards_.size())
+            throw std::out_of_range("ShardedQueue: shard index out of range");
+        return shards_[shard];
+    }
+
+    T takeBack(Shard& s)
+    {
+        T value = std::move(s.heap.back());
+        s.heap.pop_back();
+        s.size.store(s.heap.size(), std::memory_order_relaxed);
+        return value;
+    }
+
+    // Берём лучшего из подходящих. Если это не вершина кучи, куча
+    // перестраивается целиком: кража — редкий путь простаивающего врача.
+    // Занятый шард пропускаем, чтобы не стоять на чужой блокировке.
+    template <typename Eligible>
+    std::optional<T> stealFrom(Shard& s, Eligible& eligible)
+    {
+        std::unique_lock<std::mutex> lock(s.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || s.heap.empty())
+            return std::nullopt;
+
+        if (eligible(s.heap.front())) {
+            std::pop_heap(s.heap.begin(), s.heap.end(), compare_);
+            return takeBack(s);
+        }
+
+        auto best = s.heap.end();
+        for (auto it = s.heap.begin() + 1; it != s.heap.end(); ++it)
+            if (eligible(*it) && (best == s.heap.end() || compare_(*best, *it)))
+                best = it;
+        if (best == s.heap.end())
+            return std::nullopt;
+
+        std::iter_swap(best, s.heap.end() - 1);
+        T value = takeBack(s);
+        std::make_heap(s.heap.begin(), s.heap.end(), compare_);
+        return value;
+    }
+
+    std::vector<Shard> shards_;
+    Compare            compare_;
+};
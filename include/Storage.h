@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "InMemoryTable.h"
+#include "VisitColumns.h"
+
+// Строки хранилища — ровно то, что нужно очереди: пациент с триажем,
+// врач со сменой, визит со статусом. Время — секунды Unix.
+struct PatientRow {
+    std::int64_t id = 0;
+    std::string  fullName;
+    int          triage = 3; // 1 — срочнее всего
+    std::string  department;
+    std::int64_t arrivedAt = 0;
+};
+
+struct DoctorRow {
+    std::int32_t id = 0;
+    std::string  fullName;
+    std::string  specialty;
+    bool         onShift = false;
+};
+
+struct VisitRow {
+    std::int64_t id = 0; // 0 при add_visit — номер выдаёт хранилище
+    std::int64_t patientId = 0;
+    std::int32_t doctorId = 0;
+    std::int64_t visitTime = 0;
+    std::int32_t durationSec = 0;
+    VisitStatus  status = VisitStatus::Scheduled;
+};
+
+// Хранилище пациентов, врачей и визитов за очередью. Реализации:
+// InMemoryStorage (ниже) — для бенчмарков и прогонов без сервера,
+// PgStorage (PgStorage.h) — Postgres через libpq.
+// Ошибки бэкенда — Storage::Error.
+class Storage {
+public:
+    class Error : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    virtual ~Storage() = default;
+
+    virtual void                      upsert_patient(const PatientRow& row) = 0;
+    virtual std::optional<PatientRow> find_patient(std::int64_t id) = 0;
+    virtual bool                      erase_patient(std::int64_t id) = 0;
+
+    virtual void                     upsert_doctor(const DoctorRow& row) = 0;
+    virtual std::optional<DoctorRow> find_doctor(std::int32_t id) = 0;
+    virtual std::vector<DoctorRow>   doctors_on_shift() = 0;
+
+    // Возвращает id нового визита
+    virtual std::int64_t          add_visit(const VisitRow& row) = 0;
+    virtual bool                  set_visit_status(std::int64_t visitId, VisitStatus status) = 0;
+    virtual std::vector<VisitRow> visits_of_patient(std::int64_t patientId) = 0;
+    virtual std::vector<VisitRow> visits_of_doctor(std::int32_t doctorId) = 0;
+};
+
+// Хранилище в памяти процесса на InMemoryTable: хеш по первичному ключу и
+// вторичные индексы по on_shift, patient_id и doctor_id. Потокобезопасно.
+class InMemoryStorage final : public Storage {
+public:
+    InMemoryStorage()
+    {
+        doctors_.add_index("on_shift", [](const DoctorRow& d) { return std::int64_t{d.onShift}; });
+        visits_.add_index("patient_id", [](const VisitRow& v) { return v.patientId; });
+        visits_.add_index("doctor_id", [](const VisitRow& v) { return std::int64_t{v.doctorId}; });
+    }
+
+    void upsert_patient(const PatientRow& row) override { patients_.upsert(row); }
+    std::optional<PatientRow> find_patient(std::int64_t id) override { return patients_.find(id); }
+    bool erase_patient(std::int64_t id) override { return patients_.erase(id); }
+
+    void upsert_doctor(const DoctorRow& row) override { doctors_.upsert(row); }
+    std::optional<DoctorRow> find_doctor(std::int32_t id) override { return doctors_.find(id); }
+    std::vector<DoctorRow> doctors_on_shift() override { return doctors_.find_by("on_shift", 1); }
+
+    std::int64_t add_visit(const VisitRow& row) override
+    {
+        VisitRow v = row;
+        v.id = nextVisit_.fetch_add(1, std::memory_order_relaxed);
+        visits_.insert(v);
+        return v.id;
+    }
+
+    bool set_visit_status(std::int64_t visitId, VisitStatus status) override
+    {
+        return visits_.update(visitId, [status](VisitRow& v) { v.status = status; });
+    }
+
+    std::vector<VisitRow> visits_of_patient(std::int64_t patientId) override
+    {
+        return visits_.find_by("patient_id", patientId);
+    }
+
+    std::vector<VisitRow> visits_of_doctor(std::int32_t doctorId) override
+    {
+        return visits_.find_by("doctor_id", doctorId);
+    }
+
+private:
+    struct PatientKey {
+        std::int64_t operator()(const PatientRow& r) const { return r.id; }
+    };
+    struct DoctorKey {
+        std::int32_t operator()(const DoctorRow& r) const { return r.id; }
+    };
+    struct VisitKey {
+        std::int64_t operator()(const VisitRow& r) const { return r.id; }
+    };
+
+    InMemoryTable<std::int64_t, PatientRow, PatientKey> patients_;
+    InMemoryTable<std::int32_t, DoctorRow, DoctorKey>   doctors_;
+    InMemoryTable<std::int64_t, VisitRow, VisitKey>     visits_;
+    std::atomic<std::int64_t>                           nextVisit_{1};
+};
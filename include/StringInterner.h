@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Небольшой целочисленный дескриптор интернированной строки.
+// Сравнение и хеш — операции над одним uint32_t.
+struct InternedString {
+    std::uint32_t id = 0; // 0 — пустая строка
+
+    friend bool operator==(InternedString a, InternedString b) noexcept { return a.id == b.id; }
+    friend bool operator!=(InternedString a, InternedString b) noexcept { return a.id != b.id; }
+    friend bool operator<(InternedString a, InternedString b) noexcept { return a.id < b.id; }
+};
+
+namespace std {
+template <>
+struct hash<InternedString> {
+    std::size_t operator()(InternedString s) const noexcept { return s.id; }
+};
+} // namespace std
+
+// Таблица интернирования повторяющихся строк: отделения, специальности
+// врачей, диагнозы. Каждая уникальная строка хранится один раз, сущности
+// (Visit, Doctor) держат только InternedString. Дескрипторы одной таблицы
+// между собой сравнимы, дескрипторы разных таблиц — нет.
+//
+// Потокобезопасна: поиск под разделяемой блокировкой, вставка — под
+// эксклюзивной. Строки никогда не удаляются, поэтому string_view из str()
+// живёт столько же, сколько таблица.
+class StringInterner {
+public:
+    struct Stats {
+        std::size_t strings = 0; // уникальных строк
+        std::size_t bytes   = 0; // байт текста без служебных структур
+        std::size_t interns = 0; // сколько раз вызывали intern()
+        std::size_t requestedBytes = 0; // сколько текста пришло во все вызовы intern()
+
+        // Оценка экономии против хранения копии строки в каждой сущности
+        // (без учёта заголовков std::string и кучи, т.е. снизу)
+        std::size_t savedBytes() const { return requestedBytes > bytes ? requestedBytes - bytes : 0; }
+    };
+
+    StringInterner() { strings_.emplace_back(); }
+
+    StringInterner(const StringInterner&)            = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // Общая таблица процесса
+    static StringInterner& global()
+    {
+        static StringInterner instance;
+        return instance;
+    }
+
+    InternedString intern(std::string_view s)
+    {
+        if (s.empty())
+            return InternedString{};
+
+        interns_.fetch_add(1, std::memory_order_relaxed);
+        requestedBytes_.fetch_add(s.size(), std::memory_order_relaxed);
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = index_.find(s);
+            if (it != index_.end())
+                return InternedString{it->second};
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(s);
+        if (it != index_.end())
+            return InternedString{it->second};
+
+        if (strings_.size() > UINT32_MAX)
+            throw std::length_error("StringInterner: too many strings");
+        const auto id = static_cast<std::uint32_t>(strings_.size());
+        // deque не перемещает элементы при вставке в конец, view в index_ валидны
+        const std::string& stored = strings_.emplace_back(s);
+        index_.emplace(std::string_view(stored), id);
+        bytes_ += stored.size();
+        return InternedString{id};
+    }
+
+    // Без вставки: пустой дескриптор, если такой строки ещё не было
+    InternedString find(std::string_view s) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(s);
+        return it == index_.end() ? InternedString{} : InternedString{it->second};
+    }
+
+    std::string_view str(InternedString h) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (h.id >= strings_.size())
+            throw std::out_of_range("StringInterner: unknown handle");
+        return strings_[h.id];
+    }
+
+    Stats stats() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        Stats out;
+        out.strings = strings_.size() - 1;
+        out.bytes   = bytes_;
+        out.interns = interns_.load(std::memory_order_relaxed);
+        out.requestedBytes = requestedBytes_.load(std::memory_order_relaxed);
+        return out;
+    }
+
+private:
+    mutable std::shared_mutex                              mutex_;
+    std::deque<std::string>                                strings_;
+    std::unordered_map<std::string_view, std::uint32_t>    index_;
+    std::size_t                                            bytes_   = 0;
+    std::atomic<std::size_t>                               interns_{0};
+    std::atomic<std::size_t>                               requestedBytes_{0};
+};
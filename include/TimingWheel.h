@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Иерархическое колесо таймеров для записей на приём (Visit).
+// Время — в тиках (например, минутах), единицу выбирает вызывающий.
+// 4 уровня по 256 слотов покрывают 2^32 тиков вперёд, всё дальше лежит
+// в отдельном списке и переразбирается, когда обернётся верхний уровень.
+// schedule и cancel — O(1): у каждого узла есть ссылки prev/next внутри
+// слота. advance обрабатывает только слоты наступивших тиков и каскады
+// верхних уровней, полного обхода ожидающих записей нет; пустые нижние
+// уровни пропускаются прыжком до следующей границы каскада.
+template <typename T>
+class TimingWheel {
+public:
+    struct Handle {
+        std::uint32_t index      = kNil;
+        std::uint32_t generation = 0;
+    };
+
+    explicit TimingWheel(std::uint64_t now = 0) : now_(now)
+    {
+        for (auto& head : heads_)
+            head = kNil;
+    }
+
+    std::uint64_t now() const { return now_; }
+    std::size_t   size() const { return size_; }
+    bool          empty() const { return size_ == 0; }
+
+    // Ставит запись на тик due; прошедшее время сработает на следующем тике
+    Handle schedule(std::uint64_t due, T value)
+    {
+        const std::uint32_t i = allocate();
+        Node& n = nodes_[i];
+        n.value.emplace(std::move(value));
+        n.due = due > now_ ? due : now_ + 1;
+        link(i);
+        ++size_;
+        return Handle{i, n.generation};
+    }
+
+    // false — запись уже сработала или отменена
+    bool cancel(Handle h)
+    {
+        if (h.index >= nodes_.size())
+            return false;
+        Node& n = nodes_[h.index];
+        if (n.generation != h.generation || !n.value)
+            return false;
+        unlink(h.index);
+        release(h.index);
+        --size_;
+        return true;
+    }
+
+    // Продвигает время до now, вызывая fire(T&&) для каждой наступившей записи
+    template <typename Fire>
+    std::size_t advance(std::uint64_t now, Fire&& fire)
+    {
+        std::size_t fired = 0;
+        while (now_ < now) {
+            if (size_ == 0) {
+                now_ = now;
+                break;
+            }
+
+            // Нижние уровни пусты — прыгаем сразу к ближайшему каскаду
+            unsigned lowest = 0;
+            while (lowest < kLevels && levelSize_[lowest] == 0)
+                ++lowest;
+            if (lowest > 0) {
+                const std::uint64_t last = now_ | ((std::uint64_t(1) << (kBits * lowest)) - 1);
+                if (last >= now) {
+                    now_ = now;
+                    break;
+                }
+                now_ = last;
+            }
+
+            ++now_;
+            cascade();
+
+            const std::uint32_t bucket = static_cast<std::uint32_t>(now_ & kSlotMask);
+            while (heads_[bucket] != kNil) {
+                const std::uint32_t i = heads_[bucket];
+                unlink(i);
+                T value = std::move(*nodes_[i].value);
+                release(i);
+                --size_;
+                ++fired;
+                fire(std::move(value));
+            }
+        }
+        return fired;
+    }
+
+private:
+    static constexpr std::uint32_t kNil       = UINT32_MAX;
+    static constexpr unsigned      kBits      = 8;
+    static constexpr std::size_t   kSlots     = std::size_t(1) << kBits;
+    static constexpr std::uint64_t kSlotMask  = kSlots - 1;
+    static constexpr unsigned      kLevels    = 4;
+    static constexpr std::uint32_t kOverflow  = kLevels * kSlots;
+
+    struct Node {
+        std::optional<T> value;
+        std::uint64_t    due        = 0;
+        std::uint32_t    prev       = kNil;
+        std::uint32_t    next       = kNil;
+        std::uint32_t    bucket     = kNil;
+        std::uint32_t    generation = 0;
+    };
+
+    std::uint32_t bucketFor(std::uint64_t due) const
+    {
+        const std::uint64_t delta = due - now_;
+        for (unsigned level = 0; level < kLevels; ++level)
+            if (delta < (std::uint64_t(1) << (kBits * (level + 1))))
+                return static_cast<std::uint32_t>(level * kSlots + ((due >> (kBits * level)) & kSlotMask));
+        return kOverflow;
+    }
+
+    void link(std::uint32_t i)
+    {
+        Node& n = nodes_[i];
+        n.bucket = bucketFor(n.due);
+        ++levelSize_[n.bucket / kSlots];
+        n.prev = kNil;
+        n.next = heads_[n.bucket];
+        if (n.next != kNil)
+            nodes_[n.next].prev = i;
+        heads_[n.bucket] = i;
+    }
+
+    void unlink(std::uint32_t i)
+    {
+        Node& n = nodes_[i];
+        if (n.prev != kNil)
+            nodes_[n.prev].next = n.next;
+        else
+            heads_[n.bucket] = n.next;
+        if (n.next != kNil)
+            nodes_[n.next].prev = n.prev;
+        --levelSize_[n.bucket / kSlots];
+        n.prev = n.next = n.bucket = kNil;
+    }
+
+    // Когда младшие разряды времени обнулились, слот верхнего уровня
+    // раскладывается по нижним; сначала старшие уровни, потом младшие
+    void cascade()
+    {
+        if ((now_ & kSlotMask) != 0)
+            return;
+
+        unsigned top = 1;
+        while (top < kLevels && ((now_ >> (kBits * top)) & kSlotMask) == 0)
+            ++top;
+
+        if (top == kLevels)
+            relink(kOverflow);
+        for (unsigned level = top < kLevels ? top : kLevels - 1; level >= 1; --level)
+            relink(static_cast<std::uint32_t>(level * kSlots + ((now_ >> (kBits * level)) & kSlotMask)));
+    }
+
+    void relink(std::uint32_t bucket)
+    {
+        std::uint32_t i = heads_[bucket];
+        heads_[bucket] = kNil;
+        while (i != kNil) {
+            const std::uint32_t next = nodes_[i].next;
+            --levelSize_[bucket / kSlots];
+            link(i);
+            i = next;
+        }
+    }
+
+    std::uint32_t allocate()
+    {
+        if (!free_.empty()) {
+            const std::uint32_t i = free_.back();
+            free_.pop_back();
+            return i;
+        }
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void release(std::uint32_t i)
+    {
+        nodes_[i].value.reset();
+        ++nodes_[i].generation;
+        free_.push_back(i);
+    }
+
+    std::uint64_t                                now_;
+    std::size_t                                  size_ = 0;
+    std::array<std::uint32_t, kOverflow + 1>     heads_;
+    std::array<std::size_t, kLevels + 1>         levelSize_{};
+    std::vector<Node>                            nodes_;
+    std::vector<std::uint32_t>                   free_;
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+enum class VisitStatus : std::uint8_t {
+    Scheduled  = 0,
+    Arrived    = 1,
+    Called     = 2,
+    InProgress = 3,
+    Done       = 4,
+    Cancelled  = 5,
+};
+
+// Колоночное (struct-of-arrays) хранилище визитов для отчётов в памяти.
+// Каждая колонка — отдельный плотный массив, поэтому фильтры и агрегаты
+// ниже — простые циклы без ветвлений по одному-двум массивам, которые
+// компилятор векторизует (-O2/-O3, при желании -march=native).
+//
+// Время — секунды Unix, длительность — секунды.
+class VisitColumns {
+public:
+    void reserve(std::size_t n)
+    {
+        timestamp_.reserve(n);
+        patientId_.reserve(n);
+        doctorId_.reserve(n);
+        duration_.reserve(n);
+        status_.reserve(n);
+    }
+
+    void append(std::int64_t timestamp, std::int64_t patientId, std::int32_t doctorId,
+                std::int32_t durationSec, VisitStatus status)
+    {
+        if (!timestamp_.empty() && timestamp < timestamp_.back())
+            sorted_ = false;
+        timestamp_.push_back(timestamp);
+        patientId_.push_back(patientId);
+        doctorId_.push_back(doctorId);
+        duration_.push_back(durationSec);
+        status_.push_back(static_cast<std::uint8_t>(status));
+    }
+
+    void set_status(std::size_t row, VisitStatus status) { status_.at(row) = static_cast<std::uint8_t>(status); }
+
+    std::size_t size() const { return timestamp_.size(); }
+    bool        sorted_by_time() const { return sorted_; }
+
+    const std::vector<std::int64_t>& timestamps() const { return timestamp_; }
+    const std::vector<std::int64_t>& patient_ids() const { return patientId_; }
+    const std::vector<std::int32_t>& doctor_ids() const { return doctorId_; }
+    const std::vector<std::int32_t>& durations() const { return duration_; }
+    const std::vector<std::uint8_t>& statuses() const { return status_; }
+
+    // Диапазон строк [first, last), где могут лежать визиты из [from, to).
+    // Если данные дописывались по времени — бинарный поиск, иначе вся таблица.
+    std::pair<std::size_t, std::size_t> row_range(std::int64_t from, std::int64_t to) const
+    {
+        if (!sorted_)
+            return {0, size()};
+        const auto first = std::lower_bound(timestamp_.begin(), timestamp_.end(), from);
+        const auto last  = std::lower_bound(first, timestamp_.end(), to);
+        return {static_cast<std::size_t>(first - timestamp_.begin()),
+                static_cast<std::size_t>(last - timestamp_.begin())};
+    }
+
+    // Маска строк: 1 — визит в [from, to) со статусом status
+    std::vector<std::uint8_t> filter(std::int64_t from, std::int64_t to, VisitStatus status) const
+    {
+        std::vector<std::uint8_t> mask(size(), 0);
+        const auto [first, last] = row_range(from, to);
+        const std::int64_t*  ts = timestamp_.data();
+        const std::uint8_t*  st = status_.data();
+        const std::uint8_t   want = static_cast<std::uint8_t>(status);
+        std::uint8_t*        out = mask.data();
+        for (std::size_t i = first; i < last; ++i)
+            out[i] = static_cast<std::uint8_t>((ts[i] >= from) & (ts[i] < to) & (st[i] == want));
+        return mask;
+    }
+
+    std::size_t count(std::int64_t from, std::int64_t to, VisitStatus status) const
+    {
+        const auto [first, last] = row_range(from, to);
+        const std::int64_t* ts = timestamp_.data();
+        const std::uint8_t* st = status_.data();
+        const std::uint8_t  want = static_cast<std::uint8_t>(status);
+        std::size_t n = 0;
+        for (std::size_t i = first; i < last; ++i)
+            n += static_cast<std::size_t>((ts[i] >= from) & (ts[i] < to) & (st[i] == want));
+        return n;
+    }
+
+    // Средняя длительность визитов со статусом status в [from, to); 0, если таких нет
+    double average_duration(std::int64_t from, std::int64_t to, VisitStatus status) const
+    {
+        const auto [first, last] = row_range(from, to);
+        const std::int64_t* ts = timestamp_.data();
+        const std::int32_t* du = duration_.data();
+        const std::uint8_t* st = status_.data();
+        const std::uint8_t  want = static_cast<std::uint8_t>(status);
+        std::int64_t sum = 0;
+        std::int64_t n   = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            const std::int64_t hit = (ts[i] >= from) & (ts[i] < to) & (st[i] == want);
+            sum += hit * du[i];
+            n   += hit;
+        }
+        return n == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(n);
+    }
+
+    // Визиты по врачам и часам: результат [doctor * hours + hour], hour отсчитывается от from.
+    // Визиты врачей с id вне [0, doctors) и отменённые не учитываются.
+    std::vector<std::uint32_t> visits_per_doctor_per_hour(std::int64_t from, std::int64_t to,
+                                                          std::int32_t doctors) const
+    {
+        if (doctors <= 0 || to <= from)
+            throw std::invalid_argument("VisitColumns: empty doctor or time range");
+        const std::int64_t hours = (to - from + 3599) / 3600;
+        std::vector<std::uint32_t> counts(static_cast<std::size_t>(doctors * hours), 0);
+
+        const auto [first, last] = row_range(from, to);
+        const std::int64_t* ts = timestamp_.data();
+        const std::int32_t* dr = doctorId_.data();
+        const std::uint8_t* st = status_.data();
+        const auto cancelled = static_cast<std::uint8_t>(VisitStatus::Cancelled);
+        for (std::size_t i = first; i < last; ++i) {
+            if (ts[i] < from || ts[i] >= to || dr[i] < 0 || dr[i] >= doctors || st[i] == cancelled)
+                continue;
+            ++counts[static_cast<std::size_t>(dr[i] * hours + (ts[i] - from) / 3600)];
+        }
+        return counts;
+    }
+
+    void clear()
+    {
+        timestamp_.clear();
+        patientId_.clear();
+        doctorId_.clear();
+        duration_.clear();
+        status_.clear();
+        sorted_ = true;
+    }
+
+private:
+    std::vector<std::int64_t> timestamp_;
+    std::vector<std::int64_t> patientId_;
+    std::vector<std::int32_t> doctorId_;
+    std::vector<std::int32_t> duration_;
+    std::vector<std::uint8_t> status_;
+    bool                      sorted_ = true;
+};
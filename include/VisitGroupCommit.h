@@ -0,0 +1,263 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "VisitColumns.h"
+
+// Смена статуса визита: from — статус, который вызывающий видел; если в БД
+// уже другой (визит поменяли параллельно), переход отклоняется
+struct VisitTransition {
+    std::int64_t visitId = 0;
+    VisitStatus  from = VisitStatus::Scheduled;
+    VisitStatus  to = VisitStatus::Arrived;
+    std::int64_t at = 0; // секунды Unix
+};
+
+// Групповой коммит переходов Visit: конкурентные изменения копятся в окне
+// (по времени или количеству) и уходят в БД одной транзакцией вместо
+// транзакции и fsync на каждое. Каждый вызывающий получает свой future:
+// true — переход применён, false — отклонён (статус в БД уже другой),
+// исключение — транзакция пачки не прошла.
+//
+// В отличие от WriteBehindJournal ошибка не «залипает»: упавшая пачка
+// сообщается её участникам, следующие коммитятся как обычно.
+class VisitGroupCommit {
+public:
+    using Batch = std::vector<VisitTransition>;
+    // Коммитит пачку одной транзакцией и возвращает applied[i] для каждого перехода;
+    // исключение — пачка не закоммичена целиком
+    using Committer = std::function<std::vector<bool>(const Batch&)>;
+
+    struct Stats {
+        std::uint64_t transactions = 0;
+        std::uint64_t transitions  = 0;
+        std::uint64_t rejected     = 0;
+        std::uint64_t failed       = 0;
+    };
+
+    VisitGroupCommit(Committer committer,
+                     std::size_t maxBatch = 256,
+                     std::chrono::microseconds window = std::chrono::microseconds(2000))
+        : committer_(std::move(committer)), maxBatch_(maxBatch), window_(window)
+    {
+        if (maxBatch == 0)
+            throw std::invalid_argument("VisitGroupCommit: maxBatch must be > 0");
+        worker_ = std::thread([this] { run(); });
+    }
+
+    VisitGroupCommit(const VisitGroupCommit&)            = delete;
+    VisitGroupCommit& operator=(const VisitGroupCommit&) = delete;
+
+    // Досылает всё накопленное и останавливает поток
+    ~VisitGroupCommit()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+
+    // Жизненный цикл: scheduled → arrived → called → in-progress → done,
+    // из любого незавершённого состояния — cancelled
+    static bool allowed(VisitStatus from, VisitStatus to)
+    {
+        if (to == VisitStatus::Cancelled)
+            return from != VisitStatus::Done && from != VisitStatus::Cancelled;
+        switch (from) {
+        case VisitStatus::Scheduled:  return to == VisitStatus::Arrived;
+        case VisitStatus::Arrived:    return to == VisitStatus::Called;
+        case VisitStatus::Called:     return to == VisitStatus::InProgress;
+        case VisitStatus::InProgress: return to == VisitStatus::Done;
+        default:                      return false;
+        }
+    }
+
+    std::future<bool> submit(const VisitTransition& t)
+    {
+        if (!allowed(t.from, t.to))
+            throw std::invalid_argument("VisitGroupCommit: illegal transition for visit " + std::to_string(t.visitId));
+
+        std::promise<bool> promise;
+        std::future<bool> future = promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)
+                throw std::logic_error("VisitGroupCommit: submit() after shutdown");
+            pending_.push_back(Item{t, std::move(promise)});
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Item {
+        VisitTransition    transition;
+        std::promise<bool> promise;
+    };
+
+    void run()
+    {
+        std::vector<Item> items;
+        Batch batch;
+        std::unordered_set<std::int64_t> visits;
+
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !pending_.empty() || stopping_; });
+            if (pending_.empty())
+                return;
+
+            // Окно: ждём попутчиков, пока пачка не наберётся или не истечёт время
+            const auto deadline = std::chrono::steady_clock::now() + window_;
+            cv_.wait_until(lock, deadline, [this] { return pending_.size() >= maxBatch_ || stopping_; });
+
+            // Визит попадает в транзакцию не больше одного раза: следующий его
+            // переход проверяется по статусу, который запишет этот коммит
+            std::deque<Item> deferred;
+            while (!pending_.empty() && items.size() < maxBatch_) {
+                Item item = std::move(pending_.front());
+                pending_.pop_front();
+                if (visits.insert(item.transition.visitId).second)
+                    items.push_back(std::move(item));
+                else
+                    deferred.push_back(std::move(item));
+            }
+            while (!deferred.empty()) {
+                pending_.push_front(std::move(deferred.back()));
+                deferred.pop_back();
+            }
+            lock.unlock();
+
+            for (const Item& item : items)
+                batch.push_back(item.transition);
+
+            std::vector<bool> applied;
+            std::exception_ptr failure;
+            try {
+                applied = committer_(batch);
+                if (applied.size() != batch.size())
+                    throw std::logic_error("VisitGroupCommit: committer returned wrong number of results");
+            } catch (...) {
+                failure = std::current_exception();
+            }
+
+            std::uint64_t rejected = 0;
+            for (std::size_t i = 0; i < items.size(); ++i) {
+                if (failure) {
+                    items[i].promise.set_exception(failure);
+                } else {
+                    rejected += applied[i] ? 0 : 1;
+                    items[i].promise.set_value(applied[i]);
+                }
+            }
+
+            lock.lock();
+            ++stats_.transactions;
+            stats_.transitions += items.size();
+            stats_.rejected += rejected;
+            stats_.failed += failure ? items.size() : 0;
+            lock.unlock();
+
+            items.clear();
+            batch.clear();
+            visits.clear();
+        }
+    }
+
+    Committer                       committer_;
+    const std::size_t               maxBatch_;
+    const std::chrono::microseconds window_;
+
+    mutable std::mutex              mutex_;
+    std::condition_variable         cv_;
+    std::deque<Item>                pending_;
+    bool                            stopping_ = false;
+    Stats                           stats_;
+
+    std::thread                     worker_;
+};
+
+// Committer поверх libpq: вся пачка — один UPDATE по unnest() массивов,
+// то есть одна транзакция и один fsync на сервере. Переход применяется,
+// только если текущий статус совпадает с from; RETURNING сообщает, какие
+// визиты обновились. Колонки по умолчанию — id, status, status_changed_at.
+//
+// Соединение используется только из потока коммита.
+inline VisitGroupCommit::Committer pg_visit_committer(PGconn* conn,
+                                                      const std::string& table = "visits",
+                                                      const std::string& statusColumn = "status",
+                                                      const std::string& changedAtColumn = "status_changed_at")
+{
+    auto escape = [conn](const std::string& name) {
+        char* ident = PQescapeIdentifier(conn, name.c_str(), name.size());
+        if (!ident)
+            throw std::runtime_error(std::string("pg_visit_committer: ") + PQerrorMessage(conn));
+        std::string out(ident);
+        PQfreemem(ident);
+        return out;
+    };
+    const std::string status = escape(statusColumn);
+    const std::string sql = "UPDATE " + escape(table) + " AS v SET " + status + " = t.to_status, " +
+                            escape(changedAtColumn) + " = to_timestamp(t.at)" +
+                            " FROM unnest($1::bigint[], $2::smallint[], $3::smallint[], $4::bigint[])"
+                            " AS t(id, from_status, to_status, at)"
+                            " WHERE v.id = t.id AND v." + status + " = t.from_status"
+                            " RETURNING v.id";
+
+    return [conn, sql](const VisitGroupCommit::Batch& batch) {
+        std::string ids = "{", from = "{", to = "{", at = "{";
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            const char* sep = i ? "," : "";
+            ids += sep + std::to_string(batch[i].visitId);
+            from += sep + std::to_string(static_cast<int>(batch[i].from));
+            to += sep + std::to_string(static_cast<int>(batch[i].to));
+            at += sep + std::to_string(batch[i].at);
+        }
+        ids += "}";
+        from += "}";
+        to += "}";
+        at += "}";
+
+        const char* params[4] = {ids.c_str(), from.c_str(), to.c_str(), at.c_str()};
+        PGresult* res = PQexecParams(conn, sql.c_str(), 4, nullptr, params, nullptr, nullptr, 0);
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            const std::string msg = PQresultErrorMessage(res);
+            PQclear(res);
+            throw std::runtime_error("pg_visit_committer: " + msg);
+        }
+
+        std::unordered_set<std::int64_t> updated;
+        for (int row = 0; row < PQntuples(res); ++row)
+            updated.insert(std::stoll(PQgetvalue(res, row, 0)));
+        PQclear(res);
+
+        std::vector<bool> applied(batch.size());
+        for (std::size_t i = 0; i < batch.size(); ++i)
+            applied[i] = updated.count(batch[i].visitId) != 0;
+        return applied;
+    };
+}
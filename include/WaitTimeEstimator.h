@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Инкрементальная оценка ожидания для очереди одного врача (или общей
+// очереди на несколько врачей — servers).
+//
+// Порядок обслуживания — (уровень приоритета, порядок прихода); уровень 0
+// обслуживается первым, как и наименьший приоритет в IndexedDaryHeap
+// (триаж t — уровень t - 1). У каждого пациента есть номер прихода, и для
+// каждого уровня ведётся дерево Фенвика по этим номерам: число пациентов
+// и сумма ожидаемого времени приёма. Позиция и ETA — префиксные суммы:
+// все, кто на более приоритетных уровнях, плюс пришедшие раньше на своём.
+// Постановка, уход и смена приоритета — O(log n), запросы — O(L + log n),
+// где L — число уровней.
+//
+// Время приёма хранится в целых миллисекундах, чтобы суммы не копили
+// ошибку округления при бесконечных добавлениях и вычитаниях.
+class WaitTimeEstimator {
+public:
+    explicit WaitTimeEstimator(int levels = 5, int servers = 1)
+        : levels_(levels), servers_(servers), count_(levels), work_(levels), levelCount_(levels, 0),
+          levelWork_(levels, 0)
+    {
+        if (levels <= 0 || servers <= 0)
+            throw std::invalid_argument("WaitTimeEstimator: levels and servers must be positive");
+        resize(kInitialCapacity);
+    }
+
+    // false — пациент уже в очереди
+    bool enqueue(std::uint64_t id, int level, double serviceMinutes)
+    {
+        checkLevel(level);
+        if (slotOf_.count(id))
+            return false;
+        if (next_ == capacity_)
+            grow();
+
+        const std::uint32_t seq = next_++;
+        slots_[seq] = Slot{id, level, toMillis(serviceMinutes)};
+        slotOf_.emplace(id, seq);
+        add(seq, level, 1, slots_[seq].millis);
+        return true;
+    }
+
+    // Вызов к врачу или отмена
+    bool remove(std::uint64_t id)
+    {
+        auto it = slotOf_.find(id);
+        if (it == slotOf_.end())
+            return false;
+        Slot& s = slots_[it->second];
+        add(it->second, s.level, -1, -s.millis);
+        s.level = kDead;
+        slotOf_.erase(it);
+        return true;
+    }
+
+    // Пациент сохраняет свой номер прихода и встаёт на новом уровне по нему
+    bool change_priority(std::uint64_t id, int level)
+    {
+        checkLevel(level);
+        auto it = slotOf_.find(id);
+        if (it == slotOf_.end())
+            return false;
+        Slot& s = slots_[it->second];
+        add(it->second, s.level, -1, -s.millis);
+        s.level = level;
+        add(it->second, s.level, 1, s.millis);
+        return true;
+    }
+
+    bool update_service(std::uint64_t id, double serviceMinutes)
+    {
+        auto it = slotOf_.find(id);
+        if (it == slotOf_.end())
+            return false;
+        Slot& s = slots_[it->second];
+        const std::int64_t millis = toMillis(serviceMinutes);
+        add(it->second, s.level, 0, millis - s.millis);
+        s.millis = millis;
+        return true;
+    }
+
+    void set_servers(int servers)
+    {
+        if (servers <= 0)
+            throw std::invalid_argument("WaitTimeEstimator: servers must be positive");
+        servers_ = servers;
+    }
+
+    // Сколько пациентов будет вызвано раньше (0 — следующий)
+    std::optional<std::size_t> position(std::uint64_t id) const
+    {
+        auto it = slotOf_.find(id);
+        if (it == slotOf_.end())
+            return std::nullopt;
+        const Slot& s = slots_[it->second];
+        std::int64_t ahead = 0;
+        for (int l = 0; l < s.level; ++l)
+            ahead += levelCount_[l];
+        ahead += prefix(count_[s.level], it->second);
+        return static_cast<std::size_t>(ahead);
+    }
+
+    // Ожидаемое ожидание в минутах: работа впереди, поделённая на число врачей
+    std::optional<double> eta_minutes(std::uint64_t id) const
+    {
+        auto it = slotOf_.find(id);
+        if (it == slotOf_.end())
+            return std::nullopt;
+        const Slot& s = slots_[it->second];
+        std::int64_t ahead = 0;
+        for (int l = 0; l < s.level; ++l)
+            ahead += levelWork_[l];
+        ahead += prefix(work_[s.level], it->second);
+        return static_cast<double>(ahead) / kMillisPerMinute / servers_;
+    }
+
+    std::size_t size() const { return slotOf_.size(); }
+    bool        contains(std::uint64_t id) const { return slotOf_.count(id) != 0; }
+
+    double total_minutes() const
+    {
+        std::int64_t total = 0;
+        for (std::int64_t w : levelWork_)
+            total += w;
+        return static_cast<double>(total) / kMillisPerMinute;
+    }
+
+private:
+    static constexpr std::uint32_t kInitialCapacity = 1024;
+    static constexpr int           kDead = -1;
+    static constexpr double        kMillisPerMinute = 60000.0;
+
+    struct Slot {
+        std::uint64_t id = 0;
+        int           level = kDead;
+        std::int64_t  millis = 0;
+    };
+
+    static std::int64_t toMillis(double minutes)
+    {
+        if (!(minutes >= 0))
+            throw std::invalid_argument("WaitTimeEstimator: service time must be non-negative");
+        return static_cast<std::int64_t>(std::llround(minutes * kMillisPerMinute));
+    }
+
+    void checkLevel(int level) const
+    {
+        if (level < 0 || level >= levels_)
+            throw std::out_of_range("WaitTimeEstimator: priority level out of range");
+    }
+
+    // Сумма значений дерева по номерам [0, seq)
+    static std::int64_t prefix(const std::vector<std::int64_t>& tree, std::uint32_t seq)
+    {
+        std::int64_t sum = 0;
+        for (std::uint32_t i = seq; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    }
+
+    void add(std::uint32_t seq, int level, std::int64_t count, std::int64_t millis)
+    {
+        levelCount_[level] += count;
+        levelWork_[level] += millis;
+        std::vector<std::int64_t>& c = count_[level];
+        std::vector<std::int64_t>& w = work_[level];
+        for (std::uint32_t i = seq + 1; i <= capacity_; i += i & (~i + 1)) {
+            c[i] += count;
+            w[i] += millis;
+        }
+    }
+
+    // Номера кончились: если больше половины уже ушли — перенумеровываем живых
+    // подряд с сохранением порядка, иначе удваиваем. В обоих случаях деревья
+    // строятся заново за O(L * n), что амортизируется в O(1) на постановку.
+    void grow()
+    {
+        std::uint32_t live = 0;
+        for (std::uint32_t seq = 0; seq < next_; ++seq) {
+            if (slots_[seq].level == kDead)
+                continue;
+            slots_[live] = slots_[seq];
+            slotOf_[slots_[live].id] = live;
+            ++live;
+        }
+        next_ = live;
+        resize(live * 2 < capacity_ ? capacity_ : capacity_ * 2);
+    }
+
+    void resize(std::uint32_t capacity)
+    {
+        capacity_ = capacity;
+        slots_.resize(capacity);
+        for (int l = 0; l < levels_; ++l) {
+            count_[l].assign(capacity + 1, 0);
+            work_[l].assign(capacity + 1, 0);
+        }
+        for (std::uint32_t seq = next_; seq < capacity; ++seq)
+            slots_[seq] = Slot{};
+
+        // Линейная сборка дерева Фенвика: каждый узел передаёт сумму родителю
+        for (std::uint32_t seq = 0; seq < next_; ++seq) {
+            const Slot& s = slots_[seq];
+            count_[s.level][seq + 1] += 1;
+            work_[s.level][seq + 1] += s.millis;
+        }
+        for (int l = 0; l < levels_; ++l) {
+            for (std::uint32_t i = 1; i <= capacity; ++i) {
+                const std::uint32_t parent = i + (i & (~i + 1));
+                if (parent <= capacity) {
+                    count_[l][parent] += count_[l][i];
+                    work_[l][parent] += work_[l][i];
+                }
+            }
+        }
+    }
+
+    int                                         levels_;
+    int                                         servers_;
+    std::vector<std::vector<std::int64_t>>      count_;
+    std::vector<std::vector<std::int64_t>>      work_;
+    std::vector<std::int64_t>                   levelCount_;
+    std::vector<std::int64_t>                   levelWork_;
+    std::vector<Slot>                           slots_;
+    std::unordered_map<std::uint64_t, std::uint32_t> slotOf_;
+    std::uint32_t                               capacity_ = 0;
+    std::uint32_t                               next_ = 0;
+};
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Локальный append-only журнал операций PatientQueue.
+//
+// Формат записи: [u32 длина payload][u32 crc32][u64 lsn][payload],
+// CRC считается по lsn и payload. Чекпойнт лежит рядом в `<path>.ckpt`
+// (тот же формат, одна запись) и подменяется атомарно через rename.
+// При восстановлении: состояние из чекпойнта, затем хвост журнала с
+// lsn больше чекпойнтного; порванный хвост (неполная запись или плохой
+// CRC) отрезается.
+class WriteAheadLog {
+public:
+    explicit WriteAheadLog(std::string path, std::size_t syncEvery = 256)
+        : path_(std::move(path)), syncEvery_(syncEvery == 0 ? 1 : syncEvery)
+    {
+    }
+
+    WriteAheadLog(const WriteAheadLog&)            = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    ~WriteAheadLog()
+    {
+        if (fd_ < 0)
+            return;
+        try {
+            sync();
+        } catch (...) {
+        }
+        ::close(fd_);
+    }
+
+    // Открывает журнал и восстанавливает состояние.
+    // onCheckpoint(const char* data, size_t size) вызывается не более одного раза,
+    // onRecord(uint64_t lsn, const char* data, size_t size) — для каждой записи хвоста.
+    // Возвращает последний восстановленный lsn.
+    template <typename OnCheckpoint, typename OnRecord>
+    std::uint64_t recover(OnCheckpoint&& onCheckpoint, OnRecord&& onRecord)
+    {
+        if (fd_ >= 0)
+            throw std::logic_error("WriteAheadLog: already opened");
+
+        std::uint64_t checkpointLsn = 0;
+        std::vector<char> ckpt = readFile(checkpointPath());
+        if (!ckpt.empty()) {
+            std::size_t pos = 0;
+            if (!parseRecord(ckpt, pos, [&](std::uint64_t lsn, const char* data, std::size_t size) {
+                    checkpointLsn = lsn;
+                    onCheckpoint(data, size);
+                }))
+                throw std::runtime_error("WriteAheadLog: corrupted checkpoint " + checkpointPath());
+        }
+        lastLsn_ = checkpointLsn;
+
+        std::vector<char> log = readFile(path_);
+        std::size_t pos = 0;
+        while (pos < log.size()) {
+            const bool ok = parseRecord(log, pos, [&](std::uint64_t lsn, const char* data, std::size_t size) {
+                if (lsn <= checkpointLsn)
+                    return;
+                lastLsn_ = lsn;
+                onRecord(lsn, data, size);
+            });
+            if (!ok)
+                break;
+        }
+
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            throwErrno("open " + path_);
+        if (pos < log.size() && ::ftruncate(fd_, static_cast<off_t>(pos)) != 0)
+            throwErrno("ftruncate " + path_);
+
+        return lastLsn_;
+    }
+
+    // Дописывает запись в буфер; на диск с fsync уходит пачками по syncEvery
+    std::uint64_t append(const void* data, std::size_t size)
+    {
+        if (fd_ < 0)
+            throw std::logic_error("WriteAheadLog: recover() must be called first");
+        throwIfFailed();
+
+        const std::uint64_t lsn = ++lastLsn_;
+        encodeRecord(buffer_, lsn, data, size);
+        if (++pending_ >= syncEvery_)
+            sync();
+        return lsn;
+    }
+
+    // Сбрасывает буфер и делает fdatasync.
+    // Если write упал на середине (ENOSPC, EFBIG), файл откатывается к прежней
+    // длине, а буфер остаётся — повторный sync() допишет его целиком, а не
+    // после порванной записи. Не удалось откатить или упал fdatasync (после
+    // него состояние страниц на диске неизвестно) — журнал помечается
+    // испорченным, и дальнейшие append/sync/checkpoint бросают исключение.
+    void sync()
+    {
+        throwIfFailed();
+        if (fd_ < 0 || (buffer_.empty() && pending_ == 0))
+            return;
+
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0)
+            throwErrno("fstat " + path_);
+        try {
+            writeAll(fd_, buffer_.data(), buffer_.size(), path_);
+        } catch (...) {
+            if (::ftruncate(fd_, st.st_size) != 0)
+                failed_ = true;
+            throw;
+        }
+        if (::fdatasync(fd_) != 0) {
+            failed_ = true;
+            throwErrno("fdatasync " + path_);
+        }
+        buffer_.clear();
+        pending_ = 0;
+        syncedLsn_ = lastLsn_;
+    }
+
+    // Сохраняет полное состояние очереди и обрезает журнал
+    void checkpoint(const void* state, std::size_t size)
+    {
+        sync();
+
+        std::vector<char> record;
+        encodeRecord(record, lastLsn_, state, size);
+
+        const std::string tmp = checkpointPath() + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throwErrno("open " + tmp);
+        try {
+            writeAll(fd, record.data(), record.size(), tmp);
+            if (::fsync(fd) != 0)
+                throwErrno("fsync " + tmp);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+
+        if (::rename(tmp.c_str(), checkpointPath().c_str()) != 0)
+            throwErrno("rename " + tmp);
+        syncDirectory();
+
+        // Записи до чекпойнта больше не нужны; если упадём до truncate,
+        // recover всё равно пропустит их по lsn.
+        if (::ftruncate(fd_, 0) != 0)
+            throwErrno("ftruncate " + path_);
+    }
+
+    std::uint64_t lastLsn() const { return lastLsn_; }
+    bool          failed() const { return failed_; }
+    std::uint64_t syncedLsn() const { return syncedLsn_; }
+    const std::string& path() const { return path_; }
+
+    static std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0)
+    {
+        static const std::array<std::uint32_t, 256> table = [] {
+            std::array<std::uint32_t, 256> t{};
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        const auto* p = static_cast<const unsigned char*>(data);
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+private:
+    static constexpr std::size_t kHeaderSize = 4 + 4 + 8;
+
+    std::string checkpointPath() const { return path_ + ".ckpt"; }
+
+    static void encodeRecord(std::vector<char>& out, std::uint64_t lsn, const void* data, std::size_t size)
+    {
+        if (size > UINT32_MAX)
+            throw std::length_error("WriteAheadLog: record too large");
+
+        const auto len = static_cast<std::uint32_t>(size);
+        const std::uint32_t crc = crc32(data, size, crc32(&lsn, sizeof(lsn)));
+
+        const std::size_t at = out.size();
+        out.resize(at + kHeaderSize + size);
+        std::memcpy(out.data() + at, &len, 4);
+        std::memcpy(out.data() + at + 4, &crc, 4);
+        std::memcpy(out.data() + at + 8, &lsn, 8);
+        if (size != 0)
+            std::memcpy(out.data() + at + kHeaderSize, data, size);
+    }
+
+    // false — запись неполная или битая, pos не двигается
+    template <typename Fn>
+    static bool parseRecord(const std::vector<char>& buf, std::size_t& pos, Fn&& fn)
+    {
+        if (buf.size() - pos < kHeaderSize)
+            return false;
+
+        std::uint32_t len, crc;
+        std::uint64_t lsn;
+        std::memcpy(&len, buf.data() + pos, 4);
+        std::memcpy(&crc, buf.data() + pos + 4, 4);
+        std::memcpy(&lsn, buf.data() + pos + 8, 8);
+
+        if (buf.size() - pos - kHeaderSize < len)
+            return false;
+        const char* payload = buf.data() + pos + kHeaderSize;
+        if (crc32(payload, len, crc32(&lsn, sizeof(lsn))) != crc)
+            return false;
+
+        fn(lsn, payload, static_cast<std::size_t>(len));
+        pos += kHeaderSize + len;
+        return true;
+    }
+
+    // Файл читается целиком одним буфером: восстановление упирается в диск, а не в syscalls
+    static std::vector<char> readFile(const std::string& path)
+    {
+        std::vector<char> buf;
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT)
+                return buf;
+            throwErrno("open " + path);
+        }
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            errno = err;
+            throwErrno("fstat " + path);
+        }
+        buf.resize(static_cast<std::size_t>(st.st_size));
+
+        std::size_t done = 0;
+        while (done < buf.size()) {
+            ssize_t n = ::read(fd, buf.data() + done, buf.size() - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            done += static_cast<std::size_t>(n);
+        }
+        ::close(fd);
+        buf.resize(done);
+        return buf;
+    }
+
+    static void writeAll(int fd, const char* data, std::size_t size, const std::string& what)
+    {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throwErrno("write " + what);
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+
+    void syncDirectory() const
+    {
+        const auto slash = path_.rfind('/');
+        const std::string dir = slash == std::string::npos ? "." : path_.substr(0, slash == 0 ? 1 : slash);
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            throwErrno("open " + dir);
+        const int rc = ::fsync(fd);
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        if (rc != 0)
+            throwErrno("fsync " + dir);
+    }
+
+    void throwIfFailed() const
+    {
+        if (failed_)
+            throw std::runtime_error("WriteAheadLog: " + path_ + " is in an unknown state after a failed sync; reopen and recover");
+    }
+
+    [[noreturn]] static void throwErrno(const std::string& what)
+    {
+        throw std::system_error(errno, std::generic_category(), "WriteAheadLog: " + what);
+    }
+
+    std::string       path_;
+    const std::size_t syncEvery_;
+    int               fd_ = -1;
+    std::vector<char> buffer_;
+    std::size_t       pending_ = 0;
+    std::uint64_t     lastLsn_ = 0;
+    std::uint64_t     syncedLsn_ = 0;
+    bool              failed_ = false;
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Режим долговечности записи очереди в БД
+enum class Durability {
+    Sync,        // push ждёт коммита, фоновый поток коммитит сразу
+    GroupCommit, // push ждёт коммита, фоновый поток копит операции окно `window`
+    Async        // push возвращается сразу после попадания в кольцевой буфер
+};
+
+// Write-behind слой между PatientQueue и DataBaseWorker.
+// Мутации очереди пишутся в кольцевой буфер, фоновый поток забирает их
+// пачками, склеивает (coalesce) и коммитит одной транзакцией через sink.
+template <typename Op>
+class WriteBehindJournal {
+public:
+    using Batch    = std::vector<Op>;
+    using Sink     = std::function<void(Batch&)>; // коммит пачки, например через DataBaseWorker
+    using Coalesce = std::function<void(Batch&)>; // необязательное схлопывание пачки
+
+    WriteBehindJournal(Sink sink,
+                       Durability mode,
+                       std::size_t capacity = 4096,
+                       std::chrono::milliseconds window = std::chrono::milliseconds(5),
+                       Coalesce coalesce = {})
+        : sink_(std::move(sink)),
+          coalesce_(std::move(coalesce)),
+          mode_(mode),
+          window_(window),
+          ring_(capacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("WriteBehindJournal: capacity must be > 0");
+        writer_ = std::thread([this] { run(); });
+    }
+
+    WriteBehindJournal(const WriteBehindJournal&)            = delete;
+    WriteBehindJournal& operator=(const WriteBehindJournal&) = delete;
+
+    // Дописывает хвост буфера и останавливает фоновый поток
+    ~WriteBehindJournal()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        notEmpty_.notify_one();
+        writer_.join();
+    }
+
+    // Кладёт операцию в журнал. В режимах Sync/GroupCommit ждёт коммита.
+    // Если sink однажды упал, журнал переходит в состояние ошибки и
+    // бросает её из push/flush, чтобы операции не терялись молча.
+    void push(Op op)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return size_ < ring_.size() || error_; });
+        rethrowIfFailed();
+
+        ring_[(head_ + size_) % ring_.size()] = std::move(op);
+        ++size_;
+        const std::uint64_t seq = ++pushed_;
+        notEmpty_.notify_one();
+
+        if (mode_ != Durability::Async)
+            waitCommitted(lock, seq);
+    }
+
+    // Ждёт, пока всё уже положенное будет закоммичено
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        flushRequested_ = true;
+        notEmpty_.notify_one();
+        waitCommitted(lock, pushed_);
+    }
+
+    Durability mode() const { return mode_; }
+
+    std::uint64_t committed() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return committed_;
+    }
+
+private:
+    void rethrowIfFailed() const
+    {
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+    void waitCommitted(std::unique_lock<std::mutex>& lock, std::uint64_t seq)
+    {
+        committedCv_.wait(lock, [&] { return committed_ >= seq || error_; });
+        rethrowIfFailed();
+    }
+
+    void run()
+    {
+        Batch batch;
+        batch.reserve(ring_.size());
+
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [this] { return size_ > 0 || stopping_; });
+            if (size_ == 0 && stopping_)
+                return;
+
+            // Групповой коммит: даём другим писателям время докинуть операции
+            if (mode_ == Durability::GroupCommit && !stopping_) {
+                const auto deadline = std::chrono::steady_clock::now() + window_;
+                notEmpty_.wait_until(lock, deadline, [this] {
+                    return size_ == ring_.size() || stopping_ || flushRequested_;
+                });
+            }
+            flushRequested_ = false;
+
+            const std::uint64_t upTo = pushed_;
+            while (size_ > 0) {
+                batch.push_back(std::move(ring_[head_]));
+                head_ = (head_ + 1) % ring_.size();
+                --size_;
+            }
+            notFull_.notify_all();
+            lock.unlock();
+
+            std::exception_ptr failure;
+            try {
+                if (coalesce_)
+                    coalesce_(batch);
+                if (!batch.empty())
+                    sink_(batch);
+            } catch (...) {
+                failure = std::current_exception();
+            }
+            batch.clear();
+
+            lock.lock();
+            if (failure) {
+                error_ = failure;
+                notFull_.notify_all();
+            } else {
+                committed_ = upTo;
+            }
+            committedCv_.notify_all();
+            if (failure)
+                return;
+        }
+    }
+
+    Sink                      sink_;
+    Coalesce                  coalesce_;
+    const Durability          mode_;
+    const std::chrono::milliseconds window_;
+
+    mutable std::mutex        mutex_;
+    std::condition_variable   notEmpty_;
+    std::condition_variable   notFull_;
+    std::condition_variable   committedCv_;
+
+    std::vector<Op>           ring_;
+    std::size_t               head_ = 0;
+    std::size_t               size_ = 0;
+    std::uint64_t             pushed_ = 0;
+    std::uint64_t             committed_ = 0;
+    bool                      stopping_ = false;
+    bool                      flushRequested_ = false;
+    std::exception_ptr        error_;
+
+    std::thread               writer_;
+};
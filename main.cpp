@@ -1,7 +1,13 @@
 cmake_minimum_required(VERSION 3.14)
 project(Patient_Queue LANGUAGES CXX)
 
-set(CMAKE_CXX_STANDARD 17)
+option(PATIENT_QUEUE_CXX20 "Собирать в C++20 (корутины, include/Coroutines.h)" OFF)
+
+if(PATIENT_QUEUE_CXX20)
+  set(CMAKE_CXX_STANDARD 20)
+else()
+  set(CMAKE_CXX_STANDARD 17)
+endif()
 set(CMAKE_CXX_STANDARD_REQUIRED ON)
 
 # ────────────────────────────────
@@ -50,4 +56,51 @@ target_link_libraries(Patient_Queue
   PRIVATE
     pqxx   # построенная FetchContent-ом libpqxx
     pq     # системная libpq из пакета libpq-dev
-)
\ No newline at end of file
+)
+# ────────────────────────────────
+# 5. Тесты header-only компонентов (libpqxx не нужна)
+# ────────────────────────────────
+option(PATIENT_QUEUE_BUILD_TESTS "Собирать тесты из tests/" OFF)
+
+if(PATIENT_QUEUE_BUILD_TESTS)
+  enable_testing()
+  find_package(Threads REQUIRED)
+
+  set(PATIENT_QUEUE_TESTS
+      assignment_engine_test
+      mpmc_ring_buffer_test
+      priority_order_test
+      queue_snapshot_test
+      wal_recovery_test
+  )
+
+  foreach(test ${PATIENT_QUEUE_TESTS})
+    add_executable(${test} tests/${test}.cpp)
+    target_include_directories(${test} PRIVATE ${CMAKE_SOURCE_DIR}/include)
+    target_link_libraries(${test} PRIVATE Threads::Threads)
+    add_test(NAME ${test} COMMAND ${test})
+  endforeach()
+endif()
+
+# ────────────────────────────────
+# 6. Бенчмарки и симулятор нагрузки
+# ────────────────────────────────
+option(PATIENT_QUEUE_BUILD_BENCH "Собирать бенчмарки из bench/" OFF)
+
+if(PATIENT_QUEUE_BUILD_BENCH)
+  find_package(Threads REQUIRED)
+
+  set(PATIENT_QUEUE_BENCHES
+      assignment_compare
+      indexed_heap_compare
+      interner_memory
+      load_simulator
+      mpmc_compare
+  )
+
+  foreach(bench ${PATIENT_QUEUE_BENCHES})
+    add_executable(${bench} bench/${bench}.cpp)
+    target_include_directories(${bench} PRIVATE ${CMAKE_SOURCE_DIR}/include)
+    target_link_libraries(${bench} PRIVATE Threads::Threads)
+  endforeach()
+endif()
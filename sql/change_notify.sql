@@ -0,0 +1,35 @@
+-- Уведомления об изменениях для точечной инвалидации кэшей (см. include/ChangeListener.h).
+-- Триггер шлёт NOTIFY в канал TG_ARGV[0], payload — значение колонки TG_ARGV[1]
+-- (id сущности). NOTIFY транзакционный: подписчик получит id только после COMMIT,
+-- одинаковые payload внутри одной транзакции Postgres склеивает сам.
+
+CREATE OR REPLACE FUNCTION notify_entity_change() RETURNS trigger AS $$
+DECLARE
+    row_data jsonb;
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        row_data := to_jsonb(OLD);
+    ELSE
+        row_data := to_jsonb(NEW);
+    END IF;
+
+    PERFORM pg_notify(TG_ARGV[0], row_data ->> TG_ARGV[1]);
+
+    -- при смене id инвалидируем и старый ключ
+    IF TG_OP = 'UPDATE' AND (to_jsonb(OLD) ->> TG_ARGV[1]) IS DISTINCT FROM (row_data ->> TG_ARGV[1]) THEN
+        PERFORM pg_notify(TG_ARGV[0], to_jsonb(OLD) ->> TG_ARGV[1]);
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Подключение к таблицам (имена таблиц и колонок — под свою схему):
+--
+-- CREATE TRIGGER patients_notify
+--     AFTER INSERT OR UPDATE OR DELETE ON patients
+--     FOR EACH ROW EXECUTE FUNCTION notify_entity_change('patient_changed', 'id');
+--
+-- CREATE TRIGGER doctors_notify
+--     AFTER INSERT OR UPDATE OR DELETE ON doctors
+--     FOR EACH ROW EXECUTE FUNCTION notify_entity_change('doctor_changed', 'id');
@@ -0,0 +1,56 @@
+-- Партиционирование истории визитов по времени (RANGE, по суткам).
+-- Родительская таблица объявляется как PARTITION BY RANGE (<колонка времени>),
+-- партиции называются <parent>_YYYYMMDD — так же их строит include/PartitionIndex.h.
+--
+-- Пример (колонки — под свою схему):
+--
+-- CREATE TABLE visits (
+--     id          bigserial,
+--     patient_id  bigint      NOT NULL,
+--     doctor_id   integer     NOT NULL,
+--     visit_time  timestamptz NOT NULL,
+--     ...
+--     PRIMARY KEY (id, visit_time)
+-- ) PARTITION BY RANGE (visit_time);
+
+-- Партиция создаётся в схеме родителя; имя — relname родителя с суффиксом,
+-- возвращается уже с кавычками и схемой.
+CREATE OR REPLACE FUNCTION create_visit_partition(parent regclass, day date) RETURNS text AS $$
+DECLARE
+    parent_schema text;
+    parent_name   text;
+    part_name     text;
+BEGIN
+    SELECT n.nspname, c.relname INTO parent_schema, parent_name
+      FROM pg_class c JOIN pg_namespace n ON n.oid = c.relnamespace
+     WHERE c.oid = parent;
+    part_name := format('%s_%s', parent_name, to_char(day, 'YYYYMMDD'));
+
+    EXECUTE format(
+        'CREATE TABLE IF NOT EXISTS %I.%I PARTITION OF %s FOR VALUES FROM (%L) TO (%L)',
+        parent_schema, part_name, parent,
+        day::timestamp AT TIME ZONE 'UTC',
+        (day + 1)::timestamp AT TIME ZONE 'UTC');
+    RETURN format('%I.%I', parent_schema, part_name);
+END;
+$$ LANGUAGE plpgsql;
+
+-- Заранее создаёт партиции на days_ahead суток вперёд (вызывать по расписанию,
+-- например раз в сутки, чтобы вставка никогда не упиралась в отсутствие партиции)
+CREATE OR REPLACE FUNCTION ensure_visit_partitions(parent regclass, days_ahead integer DEFAULT 7)
+RETURNS void AS $$
+DECLARE
+    d date;
+BEGIN
+    FOR d IN SELECT generate_series(current_date, current_date + days_ahead, interval '1 day')::date LOOP
+        PERFORM create_visit_partition(parent, d);
+    END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Существующие партиции для заполнения PartitionIndex (PartitionIndex::list_sql(),
+-- результат — в add_name()); индекс нужно обновлять и после ensure_visit_partitions():
+--
+-- SELECT c.relname
+--   FROM pg_inherits i JOIN pg_class c ON c.oid = i.inhrelid
+--  WHERE i.inhparent = 'visits'::regclass;
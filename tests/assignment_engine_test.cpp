@@ -0,0 +1,90 @@
+// AssignmentEngine: срочный триаж назначается первым, solve() совпадает
+// с полным перебором на малых матрицах (включая запрещённые пары).
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "AssignmentEngine.h"
+#include "check.h"
+
+namespace {
+
+void urgentTriageWins()
+{
+    const AssignmentEngine::Weights w;
+    // Один врач, два пациента: триаж 1 пришёл позже триажа 5
+    const std::vector<double> cost = {
+        AssignmentEngine::pair_cost(w, true, 5, 20.0, 10.0),
+        AssignmentEngine::pair_cost(w, true, 1, 5.0, 10.0),
+    };
+    const std::vector<int> result = AssignmentEngine::solve(cost, 2, 1);
+    CHECK(result[0] == -1);
+    CHECK(result[1] == 0);
+
+    CHECK(AssignmentEngine::pair_cost(w, false, 1, 0.0, 0.0) == AssignmentEngine::kForbidden);
+}
+
+// Лучшая пара (число допустимых назначений, суммарная стоимость) перебором
+std::pair<int, double> bruteForce(const std::vector<double>& cost, std::size_t rows, std::size_t cols)
+{
+    std::vector<int> perm(std::max(rows, cols));
+    std::iota(perm.begin(), perm.end(), 0);
+    std::pair<int, double> best{-1, 0.0};
+    do {
+        int assigned = 0;
+        double total = 0;
+        for (std::size_t r = 0; r < rows; ++r) {
+            const auto c = static_cast<std::size_t>(perm[r]);
+            if (c < cols && cost[r * cols + c] != AssignmentEngine::kForbidden) {
+                ++assigned;
+                total += cost[r * cols + c];
+            }
+        }
+        if (assigned > best.first || (assigned == best.first && total < best.second))
+            best = {assigned, total};
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    return best;
+}
+
+void matchesBruteForce()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> value(-50.0, 50.0);
+    for (int iter = 0; iter < 300; ++iter) {
+        const std::size_t rows = 1 + rng() % 6;
+        const std::size_t cols = 1 + rng() % 6;
+        std::vector<double> cost(rows * cols);
+        for (double& c : cost)
+            c = rng() % 4 == 0 ? AssignmentEngine::kForbidden : value(rng);
+
+        const std::vector<int> result = AssignmentEngine::solve(cost, rows, cols);
+        std::vector<char> used(cols, 0);
+        int assigned = 0;
+        double total = 0;
+        for (std::size_t r = 0; r < rows; ++r) {
+            if (result[r] < 0)
+                continue;
+            const auto c = static_cast<std::size_t>(result[r]);
+            CHECK(!used[c]);
+            used[c] = 1;
+            CHECK(cost[r * cols + c] != AssignmentEngine::kForbidden);
+            ++assigned;
+            total += cost[r * cols + c];
+        }
+        const auto best = bruteForce(cost, rows, cols);
+        CHECK(assigned == best.first);
+        CHECK(std::abs(total - best.second) < 1e-6);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    urgentTriageWins();
+    matchesBruteForce();
+    std::puts("assignment_engine_test: OK");
+}
@@ -0,0 +1,94 @@
+// MpmcRingBuffer: бросающий конструктор не ломает очередь, и при
+// нескольких производителях и потребителях ничего не теряется.
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MpmcRingBuffer.h"
+#include "check.h"
+
+namespace {
+
+struct Fragile {
+    explicit Fragile(int v) : value(v)
+    {
+        if (v < 0)
+            throw std::invalid_argument("negative");
+    }
+    Fragile(Fragile&&) noexcept = default;
+
+    int         value;
+    std::string tag = "fragile";
+};
+
+void throwingConstructorLeavesQueueUsable()
+{
+    MpmcRingBuffer<Fragile> q(4);
+    CHECK(q.try_emplace(1));
+
+    bool threw = false;
+    try {
+        q.try_emplace(-1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(q.size_approx() == 1);
+
+    CHECK(q.try_emplace(2));
+    CHECK(q.try_emplace(3));
+    CHECK(q.try_emplace(4));
+    CHECK(!q.try_emplace(5));
+
+    for (int expected = 1; expected <= 4; ++expected) {
+        auto item = q.try_pop();
+        CHECK(item && item->value == expected);
+    }
+    CHECK(!q.try_pop());
+}
+
+void concurrentProducersAndConsumers()
+{
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 100000;
+    MpmcRingBuffer<std::uint64_t> q(1024);
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<int> consumed{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p)
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i)
+                while (!q.try_push(static_cast<std::uint64_t>(p) * kPerProducer + i))
+                    std::this_thread::yield();
+        });
+    for (int c = 0; c < kProducers; ++c)
+        threads.emplace_back([&] {
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (auto v = q.try_pop()) {
+                    sum += *v;
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    const std::uint64_t n = std::uint64_t(kProducers) * kPerProducer;
+    CHECK(sum.load() == n * (n - 1) / 2);
+}
+
+} // namespace
+
+int main()
+{
+    throwingConstructorLeavesQueueUsable();
+    concurrentProducersAndConsumers();
+    std::puts("mpmc_ring_buffer_test: OK");
+}
@@ -0,0 +1,114 @@
+// Все структуры очереди согласны в направлении приоритета: позиция из
+// QueuePositionIndex и WaitTimeEstimator совпадает с порядком, в котором
+// пациентов реально отдают IndexedDaryHeap и ShardedQueue.
+
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "IndexedDaryHeap.h"
+#include "OrderStatisticTree.h"
+#include "ShardedQueue.h"
+#include "WaitTimeEstimator.h"
+#include "check.h"
+
+namespace {
+
+constexpr int kLevels = 5; // триаж 1..5, 1 — самый срочный
+
+using Key = std::pair<int, std::uint64_t>; // (триаж, номер прихода)
+
+struct Queues {
+    IndexedDaryHeap<std::uint64_t, Key>                          heap;
+    ShardedQueue<std::tuple<int, std::uint64_t, std::uint64_t>>  sharded{1};
+    QueuePositionIndex                                           positions;
+    WaitTimeEstimator                                            estimator{kLevels};
+    std::vector<std::uint64_t>                                   arrivalOf;
+};
+
+void checkPopOrder(Queues& q)
+{
+    std::size_t expectedSize = q.positions.size();
+    while (!q.heap.empty()) {
+        const std::uint64_t id = q.heap.top().id;
+        CHECK(q.positions.position(id) == std::size_t{0});
+        CHECK(q.estimator.position(id) == std::size_t{0});
+        CHECK(q.positions.at(0) == id);
+
+        // Каждый следующий стоит ровно на своём месте
+        for (std::size_t k = 0; k < q.positions.size(); k += 7) {
+            const std::uint64_t other = q.positions.at(k);
+            CHECK(q.positions.position(other) == k);
+            CHECK(q.estimator.position(other) == k);
+        }
+
+        auto popped = q.sharded.pop(0);
+        CHECK(popped && std::get<2>(*popped) == id);
+
+        q.heap.pop();
+        q.positions.remove(id);
+        q.estimator.remove(id);
+        --expectedSize;
+        CHECK(q.positions.size() == expectedSize);
+    }
+    CHECK(!q.sharded.pop(0));
+}
+
+void randomWorkload(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> triage(1, kLevels);
+    Queues q;
+
+    constexpr std::uint64_t kPatients = 2000;
+    std::vector<int> level(kPatients);
+    for (std::uint64_t id = 0; id < kPatients; ++id) {
+        level[id] = triage(rng);
+        q.heap.push(id, Key{level[id], id});
+        q.positions.add(id, level[id], id);
+        q.estimator.enqueue(id, level[id] - 1, 10.0);
+    }
+
+    // Пересмотр триажа у части пациентов: номер прихода сохраняется
+    for (int i = 0; i < 500; ++i) {
+        const std::uint64_t id = rng() % kPatients;
+        level[id] = triage(rng);
+        q.heap.update_priority(id, Key{level[id], id});
+        q.positions.change_priority(id, level[id]);
+        q.estimator.change_priority(id, level[id] - 1);
+    }
+
+    for (std::uint64_t id = 0; id < kPatients; ++id)
+        q.sharded.push(0, {level[id], id, id});
+
+    checkPopOrder(q);
+}
+
+void mostUrgentFirst()
+{
+    IndexedDaryHeap<int, int> heap;
+    heap.push(1, 3);
+    heap.push(2, 1);
+    heap.push(3, 5);
+    CHECK(heap.top().id == 2);
+    heap.update_priority(3, 0);
+    CHECK(heap.top().id == 3);
+
+    ShardedQueue<int> sharded(1);
+    sharded.push(0, 4);
+    sharded.push(0, 2);
+    sharded.push(0, 3);
+    CHECK(sharded.pop(0) == 2);
+}
+
+} // namespace
+
+int main()
+{
+    mostUrgentFirst();
+    for (unsigned seed = 1; seed <= 5; ++seed)
+        randomWorkload(seed);
+    std::puts("priority_order_test: OK");
+}
@@ -0,0 +1,112 @@
+// Календари врачей в снимке: запись через add_schedules, чтение через
+// load_schedules — сетка, слова и поиск окон совпадают с исходными.
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "AvailabilityCalendar.h"
+#include "QueueSnapshot.h"
+#include "check.h"
+
+namespace {
+
+std::string tempPath(const char* name)
+{
+    const std::string path = "/tmp/snapshot_test_" + std::to_string(::getpid()) + "_" + name;
+    ::unlink(path.c_str());
+    return path;
+}
+
+// 5-минутная сетка на неделю, приём 9:00–18:00, часть слотов занята
+AvailabilityCalendar week(std::int64_t start, std::size_t bookedFrom)
+{
+    AvailabilityCalendar c(start, 300, 7 * 24 * 12);
+    for (std::size_t day = 0; day < 7; ++day)
+        c.open(day * 288 + 9 * 12, 9 * 12);
+    CHECK(c.book(bookedFrom, 6));
+    return c;
+}
+
+void schedulesRoundTrip()
+{
+    const std::string path = tempPath("schedules");
+    const std::int64_t monday = 1767571200;
+
+    std::vector<std::pair<std::int64_t, AvailabilityCalendar>> calendars;
+    calendars.emplace_back(17, week(monday, 9 * 12));
+    calendars.emplace_back(42, week(monday, 288 + 10 * 12));
+    calendars.emplace_back(7, AvailabilityCalendar(monday, 900, 100)); // хвост не кратен 64
+    calendars.back().second.open(3, 90);
+
+    SnapshotWriter writer(5, monday);
+    snapshot::add_schedules(writer, calendars);
+    writer.write(path);
+
+    const SnapshotReader reader(path);
+    const auto loaded = snapshot::load_schedules(reader);
+    CHECK(loaded.size() == calendars.size());
+    for (std::size_t i = 0; i < loaded.size(); ++i) {
+        const auto& [id, c] = loaded[i];
+        const AvailabilityCalendar& orig = calendars[i].second;
+        CHECK(id == calendars[i].first);
+        CHECK(c.start() == orig.start() && c.slot_seconds() == orig.slot_seconds() && c.slots() == orig.slots());
+        CHECK(c.words() == orig.words());
+        CHECK(c.free_count() == orig.free_count());
+        CHECK(c.find_first_free(6) == orig.find_first_free(6));
+    }
+    CHECK(loaded[0].second.find_first_free(6) == std::optional<std::size_t>(9 * 12 + 6));
+    CHECK(!loaded[1].second.is_free(288 + 10 * 12, 1));
+
+    ::unlink(path.c_str());
+}
+
+void fromWordsValidates()
+{
+    bool threw = false;
+    try {
+        AvailabilityCalendar::from_words(0, 300, 128, {1});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Биты за последним слотом отбрасываются
+    const auto c = AvailabilityCalendar::from_words(0, 300, 10, {~std::uint64_t(0)});
+    CHECK(c.free_count() == 10);
+}
+
+void inconsistentWordsRejected()
+{
+    const std::string path = tempPath("broken");
+    SnapshotWriter writer(1, 0);
+    const std::vector<snapshot::DoctorSchedule> schedules = {{1, 0, 300, 128, 0, 2}};
+    const std::vector<std::uint64_t> words = {~std::uint64_t(0)};
+    writer.add(snapshot::DoctorSchedules, schedules);
+    writer.add(snapshot::DoctorScheduleWords, words);
+    writer.write(path);
+
+    bool threw = false;
+    try {
+        snapshot::load_schedules(SnapshotReader(path));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    ::unlink(path.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    schedulesRoundTrip();
+    fromWordsValidates();
+    inconsistentWordsRejected();
+    std::printf("queue_snapshot_test: OK\n");
+}
@@ -0,0 +1,196 @@
+// Восстановление WriteAheadLog: порванный хвост, падение между rename
+// чекпойнта и обрезкой журнала, откат частичной записи в sync() и время
+// восстановления журнала на 1M записей.
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "WriteAheadLog.h"
+#include "check.h"
+
+namespace {
+
+std::string tempPath(const char* name)
+{
+    const std::string path = "/tmp/wal_test_" + std::to_string(::getpid()) + "_" + name;
+    ::unlink(path.c_str());
+    ::unlink((path + ".ckpt").c_str());
+    return path;
+}
+
+void cleanup(const std::string& path)
+{
+    ::unlink(path.c_str());
+    ::unlink((path + ".ckpt").c_str());
+}
+
+struct Recovered {
+    std::string                checkpoint;
+    std::vector<std::uint64_t> values;
+    std::uint64_t              lastLsn = 0;
+};
+
+Recovered recoverAll(const std::string& path)
+{
+    Recovered r;
+    WriteAheadLog wal(path);
+    r.lastLsn = wal.recover([&](const char* data, std::size_t size) { r.checkpoint.assign(data, size); },
+                            [&](std::uint64_t, const char* data, std::size_t size) {
+                                CHECK(size == sizeof(std::uint64_t));
+                                std::uint64_t v;
+                                std::memcpy(&v, data, sizeof(v));
+                                r.values.push_back(v);
+                            });
+    return r;
+}
+
+void appendValues(WriteAheadLog& wal, std::uint64_t from, std::uint64_t to)
+{
+    for (std::uint64_t v = from; v < to; ++v)
+        wal.append(&v, sizeof(v));
+}
+
+void tornTail()
+{
+    const std::string path = tempPath("torn");
+    {
+        WriteAheadLog wal(path, 1);
+        wal.recover([](const char*, std::size_t) {}, [](std::uint64_t, const char*, std::size_t) {});
+        appendValues(wal, 0, 10);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x10\x00\x00\x00garbage", 11); // заголовок без тела
+    }
+
+    {
+        Recovered r = recoverAll(path);
+        CHECK(r.values.size() == 10);
+        CHECK(r.lastLsn == 10);
+    }
+    // После обрезки хвоста новые записи читаются как обычно
+    {
+        WriteAheadLog wal(path, 1);
+        wal.recover([](const char*, std::size_t) {}, [](std::uint64_t, const char*, std::size_t) {});
+        appendValues(wal, 10, 15);
+    }
+    Recovered r = recoverAll(path);
+    CHECK(r.values.size() == 15);
+    for (std::uint64_t i = 0; i < 15; ++i)
+        CHECK(r.values[i] == i);
+    cleanup(path);
+}
+
+// Чекпойнт уже подменён, а журнал ещё не обрезан: старые записи должны пропускаться
+void crashBetweenCheckpointAndTruncate()
+{
+    const std::string path = tempPath("ckpt");
+    std::string beforeTruncate;
+    {
+        WriteAheadLog wal(path, 1);
+        wal.recover([](const char*, std::size_t) {}, [](std::uint64_t, const char*, std::size_t) {});
+        appendValues(wal, 0, 20);
+        wal.sync();
+        std::ifstream in(path, std::ios::binary);
+        beforeTruncate.assign(std::istreambuf_iterator<char>(in), {});
+        wal.checkpoint("state@20", 8);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(beforeTruncate.data(), static_cast<std::streamsize>(beforeTruncate.size()));
+    }
+
+    {
+        Recovered r = recoverAll(path);
+        CHECK(r.checkpoint == "state@20");
+        CHECK(r.values.empty());
+        CHECK(r.lastLsn == 20);
+    }
+    {
+        WriteAheadLog wal(path, 1);
+        wal.recover([](const char*, std::size_t) {}, [](std::uint64_t, const char*, std::size_t) {});
+        appendValues(wal, 20, 25);
+    }
+    Recovered r = recoverAll(path);
+    CHECK(r.checkpoint == "state@20");
+    CHECK(r.values.size() == 5);
+    CHECK(r.values.front() == 20 && r.values.back() == 24);
+    cleanup(path);
+}
+
+// write упирается в RLIMIT_FSIZE посередине буфера (как при ENOSPC):
+// повторный sync() не должен оставить порванную запись перед целыми
+void partialWriteRollsBack()
+{
+    const std::string path = tempPath("partial");
+    std::signal(SIGXFSZ, SIG_IGN);
+    rlimit old{};
+    ::getrlimit(RLIMIT_FSIZE, &old);
+
+    {
+        WriteAheadLog wal(path, 1000);
+        wal.recover([](const char*, std::size_t) {}, [](std::uint64_t, const char*, std::size_t) {});
+        appendValues(wal, 0, 10);
+        wal.sync();
+
+        rlimit small = old;
+        small.rlim_cur = 24 * 10 + 100; // влезают первые записи, дальше EFBIG
+        ::setrlimit(RLIMIT_FSIZE, &small);
+        appendValues(wal, 10, 30);
+        bool threw = false;
+        try {
+            wal.sync();
+        } catch (const std::system_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(!wal.failed());
+
+        ::setrlimit(RLIMIT_FSIZE, &old);
+        wal.sync();
+        appendValues(wal, 30, 35);
+    }
+
+    Recovered r = recoverAll(path);
+    CHECK(r.values.size() == 35);
+    for (std::uint64_t i = 0; i < 35; ++i)
+        CHECK(r.values[i] == i);
+    cleanup(path);
+}
+
+void recoveryTime()
+{
+    const std::string path = tempPath("big");
+    constexpr std::uint64_t kRecords = 1000000;
+    {
+        WriteAheadLog wal(path, 4096);
+        wal.recover([](const char*, std::size_t) {}, [](std::uint64_t, const char*, std::size_t) {});
+        appendValues(wal, 0, kRecords);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    Recovered r = recoverAll(path);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("recovered %zu records in %.1f ms\n", r.values.size(), ms);
+    CHECK(r.values.size() == kRecords);
+    CHECK(ms < 1000); // ориентир ~40 ms; порог с запасом под медленные диски и CI
+    cleanup(path);
+}
+
+} // namespace
+
+int main()
+{
+    tornTail();
+    crashBetweenCheckpointAndTruncate();
+    partialWriteRollsBack();
+    recoveryTime();
+    std::puts("wal_recovery_test: OK");
+}